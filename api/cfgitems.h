@@ -18,6 +18,7 @@
  * system header files
 \*===========================================================================*/
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /*===========================================================================*\
@@ -35,9 +36,13 @@
 #define CFGITEMS_FAILURE (-1)
 
 #define CFGITEMS_ALIGN 32
+
+/* maximal size of the value of 'string' item (including terminating null character) */
+#define CFGITEMS_STRING_MAX 128
 #define CFGITEMS_STRINGIFY(x) #x
 #define CFGITEMS_XSTR(x) CFGITEMS_STRINGIFY(x)
 #define CFGITEMS_CONCATENATE(a, b) a ## b
+#define CFGITEMS_XCONCATENATE(a, b) CFGITEMS_CONCATENATE(a, b)
 
 #define CFGITEMS_CONCATENATE_SECTION_START(section)  CFGITEMS_CONCATENATE(__start_, section)
 #define CFGITEMS_CONCATENATE_SECTION_END(section)    CFGITEMS_CONCATENATE(__stop_, section)
@@ -46,8 +51,47 @@
 #define CFGITEMS_SECTION_START  CFGITEMS_CONCATENATE_SECTION_START(CFGITEMS_SECTION_PREFIX)
 #define CFGITEMS_SECTION_END    CFGITEMS_CONCATENATE_SECTION_END(CFGITEMS_SECTION_PREFIX)
 
+/*
+ * With CFGITEMS_PRESORT defined, each item reserves CFGITEMS_INDEX_WORDS
+ * 32-bit words in the index section. The section is left zeroed by the linker.
+ * The post-link tool (cfgitems-presort) fills it with the sorted order,
+ * the hash table, the module directory and the Bloom filter of all the items,
+ * so that cfgitems_init() can use them as they are. Without CFGITEMS_PRESORT
+ * nothing is reserved and cfgitems_init() builds the index at run time.
+ */
+#define CFGITEMS_INDEX_WORDS 14
+#define CFGITEMS_INDEX_SECTION_PREFIX CFGITEMS_XCONCATENATE(CFGITEMS_SECTION_PREFIX, _index)
+
+#define CFGITEMS_INDEX_SECTION_NAME   CFGITEMS_XSTR(CFGITEMS_INDEX_SECTION_PREFIX)
+#define CFGITEMS_INDEX_SECTION_START  CFGITEMS_CONCATENATE_SECTION_START(CFGITEMS_INDEX_SECTION_PREFIX)
+#define CFGITEMS_INDEX_SECTION_END    CFGITEMS_CONCATENATE_SECTION_END(CFGITEMS_INDEX_SECTION_PREFIX)
+
+/*
+ * Values of the items are kept apart from their (cold) descriptions,
+ * densely packed in the values section, so that reading many of them
+ * touches as few cache lines as possible.
+ */
+#define CFGITEMS_VALUES_SECTION_PREFIX CFGITEMS_XCONCATENATE(CFGITEMS_SECTION_PREFIX, _values)
+#define CFGITEMS_VALUES_SECTION_NAME   CFGITEMS_XSTR(CFGITEMS_VALUES_SECTION_PREFIX)
+#define CFGITEMS_VALUES_SECTION_START  CFGITEMS_CONCATENATE_SECTION_START(CFGITEMS_VALUES_SECTION_PREFIX)
+#define CFGITEMS_VALUES_SECTION_END    CFGITEMS_CONCATENATE_SECTION_END(CFGITEMS_VALUES_SECTION_PREFIX)
+
 #define CFGITEMS_GLOBAL_MODULE _
 
+/*
+ * Items are hashed with 32-bit FNV-1a over module and name (each including
+ * its terminating null character) followed by murmur3 32-bit finalizer.
+ * The hash of an item can be computed at compile time (see cfgitems.hpp)
+ * and stored in the item by CFGITEMS_HASH_INITIALIZER(); zero means
+ * that it will be computed by cfgitems_init().
+ */
+#define CFGITEMS_HASH_OFFSET_BASIS 2166136261u
+#define CFGITEMS_HASH_PRIME          16777619u
+
+#if !defined(CFGITEMS_HASH_INITIALIZER)
+    #define CFGITEMS_HASH_INITIALIZER(_module_, _name_) 0
+#endif
+
 #define CFGITEMTYPES                        \
     CFGITEMTYPE(void*,           UNDEFINED) \
     CFGITEMTYPE(bool,            BOOL)      \
@@ -62,7 +106,52 @@
     CFGITEMTYPE(int64_t,         S64)       \
     CFGITEMTYPE(uint64_t,        U64)
 
+#define __CFGITEMS_CTYPE_UNDEFINED void*
+#define __CFGITEMS_CTYPE_BOOL      bool
+#define __CFGITEMS_CTYPE_STRING    const char*
+#define __CFGITEMS_CTYPE_DOUBLE    double
+#define __CFGITEMS_CTYPE_S8        int8_t
+#define __CFGITEMS_CTYPE_U8        uint8_t
+#define __CFGITEMS_CTYPE_S16       int16_t
+#define __CFGITEMS_CTYPE_U16       uint16_t
+#define __CFGITEMS_CTYPE_S32       int32_t
+#define __CFGITEMS_CTYPE_U32       uint32_t
+#define __CFGITEMS_CTYPE_S64       int64_t
+#define __CFGITEMS_CTYPE_U64       uint64_t
+
+#define __CFGITEMS_DECLARE(_module_, _type_, _name_)                         \
+    typedef __CFGITEMS_CTYPE_ ## _type_                                      \
+        __cfgitems_type_ ## _module_ ## _ ## _name_;                         \
+    LTS_EXTERN union cfgitems_any                                            \
+        __cfgitems_value_ ## _module_ ## _ ## _name_;                        \
+    LTS_EXTERN struct cfgitems cfgitems_ ## _module_ ## _ ## _name_
+
+#define __CFGITEMS_GET(_module_, _name_)                                     \
+    (*(const __cfgitems_type_ ## _module_ ## _ ## _name_*)                   \
+        &__cfgitems_value_ ## _module_ ## _ ## _name_)
+
+#define __CFGITEMS_HANDLE(_module_, _name_)                                  \
+    (&cfgitems_ ## _module_ ## _ ## _name_)
+
+#if defined(CFGITEMS_PRESORT)
+#define __CFGITEMS_DEFINE_INDEX(_module_, _name_)                            \
+    static uint32_t __cfgitems_index_ ## _module_ ## _ ## _name_             \
+        [CFGITEMS_INDEX_WORDS]                                               \
+        __attribute__((__section__(CFGITEMS_INDEX_SECTION_NAME)))            \
+        __attribute__((__used__))                                            \
+        __attribute__((aligned(sizeof(uint32_t))));
+#else
+#define __CFGITEMS_DEFINE_INDEX(_module_, _name_)
+#endif
+
 #define __CFGITEMS_DEFINE(_module_, _type_, _name_, _default_value_) \
+    __CFGITEMS_DECLARE(_module_, _type_, _name_);                    \
+    __CFGITEMS_DEFINE_INDEX(_module_, _name_)                        \
+    union cfgitems_any __cfgitems_value_ ## _module_ ## _ ## _name_  \
+        __attribute__((__section__(CFGITEMS_VALUES_SECTION_NAME)))   \
+        __attribute__((__used__))                                    \
+        __attribute__((aligned(sizeof(union cfgitems_any)))) =       \
+        {. _ ## _type_ ## _ = _default_value_};                      \
     struct cfgitems cfgitems_ ## _module_ ## _ ## _name_             \
         __attribute__((__section__(CFGITEMS_SECTION_NAME)))          \
         __attribute__((__used__))                                    \
@@ -70,8 +159,9 @@
         {                                                            \
             .module                      = #_module_,                \
             .type                        = CFGITEMS_TYPE_ ## _type_, \
+            .hash = CFGITEMS_HASH_INITIALIZER(#_module_, #_name_),   \
             .name                        = #_name_,                  \
-            .value = {. _ ## _type_ ## _ = _default_value_}          \
+            .value = &__cfgitems_value_ ## _module_ ## _ ## _name_   \
         }
 
 #define CFGITEMS_DEFINE_BOOL(_module_, _name_, _default_value_) \
@@ -107,6 +197,65 @@
 #define CFGITEMS_DEFINE_U64(_module_, _name_, _default_value_) \
     __CFGITEMS_DEFINE(_module_, U64, _name_, _default_value_)
 
+/*
+ * CFGITEMS_DECLARE_xxx() makes an item defined (by CFGITEMS_DEFINE_xxx())
+ * in other translation unit visible in the current one. Typically used
+ * in a header file shared by all the users of the item.
+ */
+#define CFGITEMS_DECLARE_BOOL(_module_, _name_) \
+    __CFGITEMS_DECLARE(_module_, BOOL, _name_)
+
+#define CFGITEMS_DECLARE_STRING(_module_, _name_) \
+    __CFGITEMS_DECLARE(_module_, STRING, _name_)
+
+#define CFGITEMS_DECLARE_DOUBLE(_module_, _name_) \
+    __CFGITEMS_DECLARE(_module_, DOUBLE, _name_)
+
+#define CFGITEMS_DECLARE_S8(_module_, _name_) \
+    __CFGITEMS_DECLARE(_module_, S8, _name_)
+
+#define CFGITEMS_DECLARE_U8(_module_, _name_) \
+    __CFGITEMS_DECLARE(_module_, U8, _name_)
+
+#define CFGITEMS_DECLARE_S16(_module_, _name_) \
+    __CFGITEMS_DECLARE(_module_, S16, _name_)
+
+#define CFGITEMS_DECLARE_U16(_module_, _name_) \
+    __CFGITEMS_DECLARE(_module_, U16, _name_)
+
+#define CFGITEMS_DECLARE_S32(_module_, _name_) \
+    __CFGITEMS_DECLARE(_module_, S32, _name_)
+
+#define CFGITEMS_DECLARE_U32(_module_, _name_) \
+    __CFGITEMS_DECLARE(_module_, U32, _name_)
+
+#define CFGITEMS_DECLARE_S64(_module_, _name_) \
+    __CFGITEMS_DECLARE(_module_, S64, _name_)
+
+#define CFGITEMS_DECLARE_U64(_module_, _name_) \
+    __CFGITEMS_DECLARE(_module_, U64, _name_)
+
+/*
+ * CFGITEMS_GET() evaluates to the current value of the configuration item.
+ * The item is resolved at compile/link time, so no lookup is performed
+ * and the expression has the type of the item (e.g. uint32_t for items
+ * defined with CFGITEMS_DEFINE_U32()). The item has to be either defined
+ * or declared in the current translation unit.
+ * Note that CFGITEMS_GET() reads the value directly, also when the library
+ * is built with CFGITEMS_THREAD_SAFE (use getters for items which are
+ * written concurrently).
+ */
+#define CFGITEMS_GET(_module_, _name_) \
+    __CFGITEMS_GET(_module_, _name_)
+
+/*
+ * CFGITEMS_HANDLE() evaluates to the handle (cfgitems_handle_t)
+ * of the configuration item defined or declared in the current
+ * translation unit.
+ */
+#define CFGITEMS_HANDLE(_module_, _name_) \
+    __CFGITEMS_HANDLE(_module_, _name_)
+
 /*===========================================================================*\
  * global type definitions
 \*===========================================================================*/
@@ -124,15 +273,75 @@ union cfgitems_any
 #undef CFGITEMTYPE
 };
 
+/*
+ * Immutable copy of the value of 'string' item, replaced as a whole
+ * by each update of the item.
+ */
+struct cfgitems_string;
+
 struct cfgitems
 {
     const char* module;
     enum cfgitems_type type;
+    uint32_t hash;
     const char* name;
-    union cfgitems_any value;
-    char strvalue[128];
+    union cfgitems_any* value;
+    struct cfgitems_string* string; /* set value of 'string' item, NULL while it is the default one */
+#if defined(CFGITEMS_THREAD_SAFE)
+    uint32_t seq; /* odd while the item is being written */
+#endif
 } __attribute__((aligned(CFGITEMS_ALIGN)));
 
+/*
+ * Handle of the configuration item. Obtained once by cfgitems_lookup()
+ * allows to access the item without looking it up again.
+ */
+typedef struct cfgitems* cfgitems_handle_t;
+
+/*
+ * Callback invoked by cfgitems_foreach_in_module() for each item of the module.
+ * Returning anything else than CFGITEMS_SUCCESS stops the iteration.
+ */
+typedef int (*cfgitems_callback_t)(cfgitems_handle_t handle, void* arg);
+
+/*
+ * Callback invoked by the dispatcher thread when the subscribed item
+ * has changed (see cfgitems_subscribe()).
+ */
+typedef void (*cfgitems_notify_callback_t)(cfgitems_handle_t handle, void* ctx);
+
+/*
+ * Immutable copy of the values of all the configuration items
+ * (see cfgitems_snapshot_acquire()).
+ */
+struct cfgitems_snapshot;
+
+/*
+ * Batch of updates of configuration items applied all at once
+ * (see cfgitems_txn_begin()).
+ */
+struct cfgitems_txn;
+
+/*
+ * Statistics of the per-thread caches of items looked up by module and name,
+ * summed up over all the threads (see cfgitems_get_cache_stats()).
+ */
+struct cfgitems_cache_stats
+{
+    uint64_t hits;
+    uint64_t misses;
+};
+
+/*
+ * Statistics of the sections of configuration files (and buffers)
+ * applied by the parser (see cfgitems_get_section_stats()).
+ */
+struct cfgitems_section_stats
+{
+    uint64_t applied;
+    uint64_t skipped; /* unchanged since they were applied */
+};
+
 /*===========================================================================*\
  * static inline (internal linkage) function definitions
 \*===========================================================================*/
@@ -143,6 +352,12 @@ struct cfgitems
 LTS_EXTERN struct cfgitems CFGITEMS_SECTION_START;
 LTS_EXTERN struct cfgitems CFGITEMS_SECTION_END;
 
+LTS_EXTERN uint32_t CFGITEMS_INDEX_SECTION_START[];
+LTS_EXTERN uint32_t CFGITEMS_INDEX_SECTION_END[];
+
+LTS_EXTERN union cfgitems_any CFGITEMS_VALUES_SECTION_START[];
+LTS_EXTERN union cfgitems_any CFGITEMS_VALUES_SECTION_END[];
+
 /*===========================================================================*\
  * function forward declarations (external linkage)
 \*===========================================================================*/
@@ -168,6 +383,198 @@ LTS_EXTERN int cfgitems_init(const char* filename);
  */
 LTS_EXTERN int cfgitems_parse(const char* filename);
 
+/**
+ * Parses configuration held in memory (e.g. embedded in the executable
+ * or received over the network), the same way cfgitems_parse() parses
+ * configuration files. The buffer is neither modified nor copied
+ * and does not need to be null terminated. Several threads may parse
+ * their configurations at the same time.
+ *
+ * @param[in] buf Configuration in .ini file format.
+ * @param[in] size Size of the configuration (in bytes).
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_parse_buffer(const char* buf, size_t size);
+
+/**
+ * Parses configuration read from the file descriptor (e.g. a pipe,
+ * a socket or stdin) until the end of the input. Lines are applied
+ * as soon as they have been read, so parsing overlaps with producing
+ * the configuration. Lines can be of any length. The descriptor
+ * is not closed.
+ *
+ * @param[in] fd File descriptor to read the configuration (in .ini file
+ *               format) from.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (the lines read before the failure have been applied).
+ */
+LTS_EXTERN int cfgitems_parse_fd(int fd);
+
+/**
+ * Loads configuration compiled by cfgitems-compile tool. The values
+ * of the image are already converted to the types of their items,
+ * so they are applied in a single pass without any text parsing.
+ * The image has to be compiled against the very executable (its
+ * configuration items) loading it, images which do not match
+ * the items, are truncated or corrupted are rejected as a whole.
+ *
+ * @param[in] filename Path to the compiled configuration.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (nothing has been applied).
+ */
+LTS_EXTERN int cfgitems_load_compiled(const char* filename);
+
+/**
+ * Starts watching configuration file (with inotify, by a thread of its own)
+ * and reloading it whenever it changes, also when a new file is renamed
+ * over it. The file is reloaded only once it has not changed for
+ * the debounce period, so a burst of writes results in a single reload.
+ * Reloads write (and notify) only the items whose values have changed,
+ * readers never wait for them (items read by other threads have to be
+ * guarded with CFGITEMS_THREAD_SAFE). The file is not parsed by this call.
+ * Only one file can be watched at a time.
+ *
+ * @param[in] filename Path to the file containing configuration items
+ *                     in .ini file format. Its directory has to exist,
+ *                     the file itself does not need to.
+ * @param[in] debounce_ms Debounce period (in milliseconds).
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (e.g. when a file is watched already).
+ */
+LTS_EXTERN int cfgitems_reload_start(const char* filename, unsigned debounce_ms);
+
+/**
+ * Stops watching configuration file started by cfgitems_reload_start().
+ * Waits for the reload in progress (if any) to complete.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (no file is watched).
+ */
+LTS_EXTERN int cfgitems_reload_stop(void);
+
+/**
+ * Returns number of reloads done by the watcher started
+ * by cfgitems_reload_start().
+ *
+ * @return Number of reloads since the start of the process.
+ */
+LTS_EXTERN uint64_t cfgitems_reloads(void);
+
+/**
+ * Freezes configuration items, i.e. makes them read-only for the rest
+ * of the process. Afterwards all the updates (cfgitems_set_xxx(),
+ * cfgitems_parse(), cfgitems_parse_buffer(), cfgitems_parse_fd(), reloads,
+ * cfgitems_load_compiled(), cfgitems_txn_commit()) fail, and the memory holding the items, their
+ * values and the presorted index is write protected (whole pages of it),
+ * so that stray writes fault at once. Getters do not synchronize
+ * with writers any more. Must not be called while any item is being
+ * updated.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (the library is not initialized or the memory could not be
+ *         write protected, in which case the items are frozen anyway).
+ */
+LTS_EXTERN int cfgitems_freeze(void);
+
+/**
+ * Looks up configuration item and checks its type.
+ *
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] type Expected type of the configuration item.
+ * @param[out] handle Pointer to the variable which will be assigned
+ *                    with the handle of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (e.g. when there is no such item or its type is different).
+ */
+LTS_EXTERN int cfgitems_lookup(const char* module, const char* name, enum cfgitems_type type,
+    cfgitems_handle_t* handle);
+
+/**
+ * Looks up configuration item by its precomputed hash and checks its type.
+ *
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] hash Hash of the (module, name) key, as computed by
+ *                 lts::cfgitems::hash_key() (see cfgitems.hpp).
+ *                 Note that global module is hashed by its name
+ *                 (CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE)).
+ * @param[in] type Expected type of the configuration item.
+ * @param[out] handle Pointer to the variable which will be assigned
+ *                    with the handle of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (e.g. when there is no such item or its type is different).
+ */
+LTS_EXTERN int cfgitems_lookup_hashed(const char* module, const char* name, uint32_t hash,
+    enum cfgitems_type type, cfgitems_handle_t* handle);
+
+/**
+ * Calls the callback for each configuration item of the module
+ * (in the alphabetical order of their names).
+ *
+ * @param[in] module Module name the items belong to
+ *                   (NULL denotes the global module).
+ * @param[in] callback Function to be called for each item.
+ * @param[in] arg Argument passed to the callback as it is.
+ *
+ * @return CFGITEMS_SUCCESS when all the items have been visited,
+ *         CFGITEMS_FAILURE when there is no such module, or the value
+ *         returned by the callback if it has stopped the iteration.
+ */
+LTS_EXTERN int cfgitems_foreach_in_module(const char* module, cfgitems_callback_t callback,
+    void* arg);
+
+/**
+ * Returns number of look ups (including those of the parser) rejected
+ * by the Bloom filter, i.e. of the keys which were found not to be there
+ * without searching for them.
+ *
+ * @return Number of look ups rejected since the start of the process.
+ */
+LTS_EXTERN uint64_t cfgitems_filtered_misses(void);
+
+/**
+ * Gets statistics of the look up cache of the calling thread.
+ *
+ * Each thread remembers the items it has recently looked up by module
+ * and name (cfgitems_get_xxx(), cfgitems_set_xxx(), cfgitems_lookup()),
+ * keyed by the addresses of the passed strings. Repeated look ups with
+ * the same strings (e.g. string literals) are then served from the cache.
+ *
+ * Hits and misses are summed up over all the threads (including the exited
+ * ones), so a monitoring thread sees those of the worker threads.
+ *
+ * @param[out] stats Pointer to the structure which will be assigned
+ *                   with the statistics of all the threads.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_get_cache_stats(struct cfgitems_cache_stats* stats);
+
+/**
+ * Gets statistics of the sections applied by the parser.
+ *
+ * cfgitems_parse() and cfgitems_parse_buffer() digest each section
+ * of the configuration (the lines preceding the first one make the section
+ * of the global module). A section is skipped, without converting any
+ * of its values, when it is the very section applied last to the items
+ * of its module and none of them has been written since. Sections
+ * of unknown modules are neither applied nor skipped. Configuration
+ * streamed by cfgitems_parse_fd() is always applied.
+ *
+ * @param[out] stats Pointer to the structure which will be assigned
+ *                   with the statistics (since the start of the process).
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_get_section_stats(struct cfgitems_section_stats* stats);
+
 /**
  * Gets value of 'bool' configuration item.
  *
@@ -191,6 +598,27 @@ LTS_EXTERN int cfgitems_get_bool(const char* module, const char* name, bool* val
  */
 LTS_EXTERN int cfgitems_set_bool(const char* module, const char* name, bool value);
 
+/**
+ * Gets value of 'bool' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_get_bool_h(cfgitems_handle_t handle, bool* value);
+
+/**
+ * Sets value of 'bool' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Value of the configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_set_bool_h(cfgitems_handle_t handle, bool value);
+
 /**
  * Attempts to convert a string to a boolean value.
  *
@@ -203,6 +631,10 @@ LTS_EXTERN int cfgitems_to_bool(const char* str, bool* value);
 
 /**
  * Gets value of 'string (const char*)' configuration item.
+ * Each update of the item replaces the whole string, but the replaced
+ * one stays valid and unchanged until the program calls cfgitems_reclaim()
+ * (and, if it has been obtained within cfgitems_read_lock() and
+ * cfgitems_read_unlock(), until that section ends as well).
  *
  * @param[in] module Module name the item belongs to.
  * @param[in] name Name of the configuration item.
@@ -224,6 +656,79 @@ LTS_EXTERN int cfgitems_get_string(const char* module, const char* name, const c
  */
 LTS_EXTERN int cfgitems_set_string(const char* module, const char* name, const char* value);
 
+/**
+ * Gets value of 'string (const char*)' configuration item identified by the handle
+ * (see cfgitems_get_string()).
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_get_string_h(cfgitems_handle_t handle, const char** value);
+
+/**
+ * Sets value of 'string (const char*)' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Value of the configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_set_string_h(cfgitems_handle_t handle, const char* value);
+
+/**
+ * Copies value of 'string (const char*)' configuration item into the buffer.
+ * Unlike cfgitems_get_string(), it is safe with respect to concurrent updates
+ * of the item when the library is built with CFGITEMS_THREAD_SAFE.
+ *
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[out] buf Buffer the value will be copied to (including terminating null character).
+ * @param[in] size Size of the buffer.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (e.g. when the value does not fit into the buffer).
+ */
+LTS_EXTERN int cfgitems_copy_string(const char* module, const char* name, char* buf, size_t size);
+
+/**
+ * Copies value of 'string (const char*)' configuration item identified
+ * by the handle into the buffer (see cfgitems_copy_string()).
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] buf Buffer the value will be copied to (including terminating null character).
+ * @param[in] size Size of the buffer.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_copy_string_h(cfgitems_handle_t handle, char* buf, size_t size);
+
+/**
+ * Begins the read side critical section of the calling thread. Strings
+ * returned by cfgitems_get_string() (as well as those read with CFGITEMS_GET()
+ * or through bound variables) within the section stay valid and unchanged
+ * until the section ends, even when the items are updated and cfgitems_reclaim()
+ * is called meanwhile. Sections may be nested. They are cheap (no lock is taken),
+ * but should be kept short, as cfgitems_reclaim() frees no string they could see.
+ */
+LTS_EXTERN void cfgitems_read_lock(void);
+
+/**
+ * Ends the read side critical section begun by cfgitems_read_lock().
+ */
+LTS_EXTERN void cfgitems_read_unlock(void);
+
+/**
+ * Frees the strings replaced by updates of 'string' items, except those
+ * which read side critical sections still in progress could have obtained.
+ * Replaced strings are never freed otherwise, so programs updating strings
+ * repeatedly should call it periodically, at points where no thread uses
+ * a string obtained outside of a read side critical section any more.
+ */
+LTS_EXTERN void cfgitems_reclaim(void);
+
 /**
  * Gets value of 'double' configuration item.
  *
@@ -247,6 +752,27 @@ LTS_EXTERN int cfgitems_get_double(const char* module, const char* name, double*
  */
 LTS_EXTERN int cfgitems_set_double(const char* module, const char* name, double value);
 
+/**
+ * Gets value of 'double' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_get_double_h(cfgitems_handle_t handle, double* value);
+
+/**
+ * Sets value of 'double' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Value of the configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_set_double_h(cfgitems_handle_t handle, double value);
+
 /**
  * Attempts to convert a string to a double value.
  *
@@ -280,6 +806,27 @@ LTS_EXTERN int cfgitems_get_s8(const char* module, const char* name, int8_t* val
  */
 LTS_EXTERN int cfgitems_set_s8(const char* module, const char* name, int8_t value);
 
+/**
+ * Gets value of 's8 (int8_t)' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_get_s8_h(cfgitems_handle_t handle, int8_t* value);
+
+/**
+ * Sets value of 's8 (int8_t)' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Value of the configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_set_s8_h(cfgitems_handle_t handle, int8_t value);
+
 /**
  * Attempts to convert a string to a signed 8-bits-wide integer value.
  *
@@ -313,6 +860,27 @@ LTS_EXTERN int cfgitems_get_u8(const char* module, const char* name, uint8_t* va
  */
 LTS_EXTERN int cfgitems_set_u8(const char* module, const char* name, uint8_t value);
 
+/**
+ * Gets value of 'u8 (uint8_t)' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_get_u8_h(cfgitems_handle_t handle, uint8_t* value);
+
+/**
+ * Sets value of 'u8 (uint8_t)' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Value of the configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_set_u8_h(cfgitems_handle_t handle, uint8_t value);
+
 /**
  * Attempts to convert a string to an unsigned 8-bits-wide integer value.
  *
@@ -346,6 +914,27 @@ LTS_EXTERN int cfgitems_get_s16(const char* module, const char* name, int16_t* v
  */
 LTS_EXTERN int cfgitems_set_s16(const char* module, const char* name, int16_t value);
 
+/**
+ * Gets value of 's16 (int16_t)' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_get_s16_h(cfgitems_handle_t handle, int16_t* value);
+
+/**
+ * Sets value of 's16 (int16_t)' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Value of the configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_set_s16_h(cfgitems_handle_t handle, int16_t value);
+
 /**
  * Attempts to convert a string to a signed 16-bits-wide integer value.
  *
@@ -379,6 +968,27 @@ LTS_EXTERN int cfgitems_get_u16(const char* module, const char* name, uint16_t*
  */
 LTS_EXTERN int cfgitems_set_u16(const char* module, const char* name, uint16_t value);
 
+/**
+ * Gets value of 'u16 (uint16_t)' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_get_u16_h(cfgitems_handle_t handle, uint16_t* value);
+
+/**
+ * Sets value of 'u16 (uint16_t)' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Value of the configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_set_u16_h(cfgitems_handle_t handle, uint16_t value);
+
 /**
  * Attempts to convert a string to an unsigned 16-bits-wide integer value.
  *
@@ -413,9 +1023,30 @@ LTS_EXTERN int cfgitems_get_s32(const char* module, const char* name, int32_t* v
 LTS_EXTERN int cfgitems_set_s32(const char* module, const char* name, int32_t value);
 
 /**
- * Attempts to convert a string to a signed 32-bits-wide integer value.
+ * Gets value of 's32 (int32_t)' configuration item identified by the handle.
  *
- * @param[in] str Pointer to the string to be converted.
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_get_s32_h(cfgitems_handle_t handle, int32_t* value);
+
+/**
+ * Sets value of 's32 (int32_t)' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Value of the configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_set_s32_h(cfgitems_handle_t handle, int32_t value);
+
+/**
+ * Attempts to convert a string to a signed 32-bits-wide integer value.
+ *
+ * @param[in] str Pointer to the string to be converted.
  * @param[out] value Pointer to the object to be assigned with the converted value.
  *
  * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
@@ -445,6 +1076,27 @@ LTS_EXTERN int cfgitems_get_u32(const char* module, const char* name, uint32_t*
  */
 LTS_EXTERN int cfgitems_set_u32(const char* module, const char* name, uint32_t value);
 
+/**
+ * Gets value of 'u32 (uint32_t)' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_get_u32_h(cfgitems_handle_t handle, uint32_t* value);
+
+/**
+ * Sets value of 'u32 (uint32_t)' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Value of the configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_set_u32_h(cfgitems_handle_t handle, uint32_t value);
+
 /**
  * Attempts to convert a string to an unsigned 32-bits-wide integer value.
  *
@@ -478,6 +1130,27 @@ LTS_EXTERN int cfgitems_get_s64(const char* module, const char* name, int64_t* v
  */
 LTS_EXTERN int cfgitems_set_s64(const char* module, const char* name, int64_t value);
 
+/**
+ * Gets value of 's64 (int64_t)' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_get_s64_h(cfgitems_handle_t handle, int64_t* value);
+
+/**
+ * Sets value of 's64 (int64_t)' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Value of the configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_set_s64_h(cfgitems_handle_t handle, int64_t value);
+
 /**
  * Attempts to convert a string to a signed 64-bits-wide integer value.
  *
@@ -511,6 +1184,27 @@ LTS_EXTERN int cfgitems_get_u64(const char* module, const char* name, uint64_t*
  */
 LTS_EXTERN int cfgitems_set_u64(const char* module, const char* name, uint64_t value);
 
+/**
+ * Gets value of 'u64 (uint64_t)' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_get_u64_h(cfgitems_handle_t handle, uint64_t* value);
+
+/**
+ * Sets value of 'u64 (uint64_t)' configuration item identified by the handle.
+ *
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Value of the configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_set_u64_h(cfgitems_handle_t handle, uint64_t value);
+
 /**
  * Attempts to convert a string to an unsigned 64-bits-wide integer value.
  *
@@ -521,4 +1215,600 @@ LTS_EXTERN int cfgitems_set_u64(const char* module, const char* name, uint64_t v
  */
 LTS_EXTERN int cfgitems_to_u64(const char* str, uint64_t* value);
 
+/**
+ * Acquires the current snapshot of the values of all the configuration items.
+ * The snapshot never changes, so the values read from it are consistent
+ * with each other, regardless of concurrent updates. Updates only mark
+ * the current snapshot out of date, the first call after an update takes
+ * a new one (under a lock shared with other such calls and with batches
+ * of updates, see cfgitems_txn_commit()). Otherwise acquiring and reading
+ * a snapshot takes no lock and writes only to the memory of the calling thread.
+ * While items are being set all the time, a snapshot consistent with them
+ * may not be possible to take, then the previous one is returned.
+ *
+ * @return Pointer to the snapshot or NULL on failure (e.g. when the calling
+ *         thread already holds too many snapshots). The snapshot has to be
+ *         released by the same thread with cfgitems_snapshot_release().
+ */
+LTS_EXTERN const struct cfgitems_snapshot* cfgitems_snapshot_acquire(void);
+
+/**
+ * Releases the snapshot acquired by cfgitems_snapshot_acquire().
+ * The snapshot is freed once no thread holds it and a newer one is taken.
+ *
+ * @param[in] snapshot Snapshot to be released (can be NULL).
+ */
+LTS_EXTERN void cfgitems_snapshot_release(const struct cfgitems_snapshot* snapshot);
+
+/**
+ * Returns version of the snapshot. Each snapshot taken has a version
+ * greater than the previous one.
+ *
+ * @param[in] snapshot Snapshot acquired by cfgitems_snapshot_acquire().
+ *
+ * @return Version of the snapshot (0 for NULL snapshot).
+ */
+LTS_EXTERN uint64_t cfgitems_snapshot_version(const struct cfgitems_snapshot* snapshot);
+
+/**
+ * Gets value of 'bool' configuration item identified by the handle
+ * from the snapshot.
+ *
+ * @param[in] snapshot Snapshot acquired by cfgitems_snapshot_acquire().
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_snapshot_get_bool(const struct cfgitems_snapshot* snapshot,
+    cfgitems_handle_t handle, bool* value);
+
+/**
+ * Gets value of 'string (const char*)' configuration item identified by the handle
+ * from the snapshot.
+ *
+ * @param[in] snapshot Snapshot acquired by cfgitems_snapshot_acquire().
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_snapshot_get_string(const struct cfgitems_snapshot* snapshot,
+    cfgitems_handle_t handle, const char** value);
+
+/**
+ * Gets value of 'double' configuration item identified by the handle
+ * from the snapshot.
+ *
+ * @param[in] snapshot Snapshot acquired by cfgitems_snapshot_acquire().
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_snapshot_get_double(const struct cfgitems_snapshot* snapshot,
+    cfgitems_handle_t handle, double* value);
+
+/**
+ * Gets value of 's8 (int8_t)' configuration item identified by the handle
+ * from the snapshot.
+ *
+ * @param[in] snapshot Snapshot acquired by cfgitems_snapshot_acquire().
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_snapshot_get_s8(const struct cfgitems_snapshot* snapshot,
+    cfgitems_handle_t handle, int8_t* value);
+
+/**
+ * Gets value of 'u8 (uint8_t)' configuration item identified by the handle
+ * from the snapshot.
+ *
+ * @param[in] snapshot Snapshot acquired by cfgitems_snapshot_acquire().
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_snapshot_get_u8(const struct cfgitems_snapshot* snapshot,
+    cfgitems_handle_t handle, uint8_t* value);
+
+/**
+ * Gets value of 's16 (int16_t)' configuration item identified by the handle
+ * from the snapshot.
+ *
+ * @param[in] snapshot Snapshot acquired by cfgitems_snapshot_acquire().
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_snapshot_get_s16(const struct cfgitems_snapshot* snapshot,
+    cfgitems_handle_t handle, int16_t* value);
+
+/**
+ * Gets value of 'u16 (uint16_t)' configuration item identified by the handle
+ * from the snapshot.
+ *
+ * @param[in] snapshot Snapshot acquired by cfgitems_snapshot_acquire().
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_snapshot_get_u16(const struct cfgitems_snapshot* snapshot,
+    cfgitems_handle_t handle, uint16_t* value);
+
+/**
+ * Gets value of 's32 (int32_t)' configuration item identified by the handle
+ * from the snapshot.
+ *
+ * @param[in] snapshot Snapshot acquired by cfgitems_snapshot_acquire().
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_snapshot_get_s32(const struct cfgitems_snapshot* snapshot,
+    cfgitems_handle_t handle, int32_t* value);
+
+/**
+ * Gets value of 'u32 (uint32_t)' configuration item identified by the handle
+ * from the snapshot.
+ *
+ * @param[in] snapshot Snapshot acquired by cfgitems_snapshot_acquire().
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_snapshot_get_u32(const struct cfgitems_snapshot* snapshot,
+    cfgitems_handle_t handle, uint32_t* value);
+
+/**
+ * Gets value of 's64 (int64_t)' configuration item identified by the handle
+ * from the snapshot.
+ *
+ * @param[in] snapshot Snapshot acquired by cfgitems_snapshot_acquire().
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_snapshot_get_s64(const struct cfgitems_snapshot* snapshot,
+    cfgitems_handle_t handle, int64_t* value);
+
+/**
+ * Gets value of 'u64 (uint64_t)' configuration item identified by the handle
+ * from the snapshot.
+ *
+ * @param[in] snapshot Snapshot acquired by cfgitems_snapshot_acquire().
+ * @param[in] handle Handle of the configuration item (see cfgitems_lookup()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_snapshot_get_u64(const struct cfgitems_snapshot* snapshot,
+    cfgitems_handle_t handle, uint64_t* value);
+
+/**
+ * Begins a transaction, i.e. a batch of updates of configuration items
+ * which are either all applied at once by cfgitems_txn_commit(), or none
+ * of them is. Snapshots (see cfgitems_snapshot_acquire()) never capture
+ * the batch applied only partially and the whole batch results in just
+ * a single new snapshot.
+ *
+ * @return Pointer to the transaction or NULL on failure.
+ */
+LTS_EXTERN struct cfgitems_txn* cfgitems_txn_begin(void);
+
+/**
+ * Stages update of 'bool' configuration item in the transaction.
+ * The item is looked up (and its type checked) when the transaction
+ * is committed.
+ *
+ * @param[in] txn Transaction started by cfgitems_txn_begin().
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] value New value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (the transaction will then be rejected by cfgitems_txn_commit()).
+ */
+LTS_EXTERN int cfgitems_txn_set_bool(struct cfgitems_txn* txn, const char* module, const char* name,
+    bool value);
+
+/**
+ * Stages update of 'string (const char*)' configuration item in the transaction.
+ * The item is looked up (and its type checked) when the transaction
+ * is committed.
+ *
+ * @param[in] txn Transaction started by cfgitems_txn_begin().
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] value New value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (the transaction will then be rejected by cfgitems_txn_commit()).
+ */
+LTS_EXTERN int cfgitems_txn_set_string(struct cfgitems_txn* txn, const char* module, const char* name,
+    const char* value);
+
+/**
+ * Stages update of 'double' configuration item in the transaction.
+ * The item is looked up (and its type checked) when the transaction
+ * is committed.
+ *
+ * @param[in] txn Transaction started by cfgitems_txn_begin().
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] value New value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (the transaction will then be rejected by cfgitems_txn_commit()).
+ */
+LTS_EXTERN int cfgitems_txn_set_double(struct cfgitems_txn* txn, const char* module, const char* name,
+    double value);
+
+/**
+ * Stages update of 's8 (int8_t)' configuration item in the transaction.
+ * The item is looked up (and its type checked) when the transaction
+ * is committed.
+ *
+ * @param[in] txn Transaction started by cfgitems_txn_begin().
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] value New value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (the transaction will then be rejected by cfgitems_txn_commit()).
+ */
+LTS_EXTERN int cfgitems_txn_set_s8(struct cfgitems_txn* txn, const char* module, const char* name,
+    int8_t value);
+
+/**
+ * Stages update of 'u8 (uint8_t)' configuration item in the transaction.
+ * The item is looked up (and its type checked) when the transaction
+ * is committed.
+ *
+ * @param[in] txn Transaction started by cfgitems_txn_begin().
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] value New value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (the transaction will then be rejected by cfgitems_txn_commit()).
+ */
+LTS_EXTERN int cfgitems_txn_set_u8(struct cfgitems_txn* txn, const char* module, const char* name,
+    uint8_t value);
+
+/**
+ * Stages update of 's16 (int16_t)' configuration item in the transaction.
+ * The item is looked up (and its type checked) when the transaction
+ * is committed.
+ *
+ * @param[in] txn Transaction started by cfgitems_txn_begin().
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] value New value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (the transaction will then be rejected by cfgitems_txn_commit()).
+ */
+LTS_EXTERN int cfgitems_txn_set_s16(struct cfgitems_txn* txn, const char* module, const char* name,
+    int16_t value);
+
+/**
+ * Stages update of 'u16 (uint16_t)' configuration item in the transaction.
+ * The item is looked up (and its type checked) when the transaction
+ * is committed.
+ *
+ * @param[in] txn Transaction started by cfgitems_txn_begin().
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] value New value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (the transaction will then be rejected by cfgitems_txn_commit()).
+ */
+LTS_EXTERN int cfgitems_txn_set_u16(struct cfgitems_txn* txn, const char* module, const char* name,
+    uint16_t value);
+
+/**
+ * Stages update of 's32 (int32_t)' configuration item in the transaction.
+ * The item is looked up (and its type checked) when the transaction
+ * is committed.
+ *
+ * @param[in] txn Transaction started by cfgitems_txn_begin().
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] value New value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (the transaction will then be rejected by cfgitems_txn_commit()).
+ */
+LTS_EXTERN int cfgitems_txn_set_s32(struct cfgitems_txn* txn, const char* module, const char* name,
+    int32_t value);
+
+/**
+ * Stages update of 'u32 (uint32_t)' configuration item in the transaction.
+ * The item is looked up (and its type checked) when the transaction
+ * is committed.
+ *
+ * @param[in] txn Transaction started by cfgitems_txn_begin().
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] value New value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (the transaction will then be rejected by cfgitems_txn_commit()).
+ */
+LTS_EXTERN int cfgitems_txn_set_u32(struct cfgitems_txn* txn, const char* module, const char* name,
+    uint32_t value);
+
+/**
+ * Stages update of 's64 (int64_t)' configuration item in the transaction.
+ * The item is looked up (and its type checked) when the transaction
+ * is committed.
+ *
+ * @param[in] txn Transaction started by cfgitems_txn_begin().
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] value New value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (the transaction will then be rejected by cfgitems_txn_commit()).
+ */
+LTS_EXTERN int cfgitems_txn_set_s64(struct cfgitems_txn* txn, const char* module, const char* name,
+    int64_t value);
+
+/**
+ * Stages update of 'u64 (uint64_t)' configuration item in the transaction.
+ * The item is looked up (and its type checked) when the transaction
+ * is committed.
+ *
+ * @param[in] txn Transaction started by cfgitems_txn_begin().
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] value New value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (the transaction will then be rejected by cfgitems_txn_commit()).
+ */
+LTS_EXTERN int cfgitems_txn_set_u64(struct cfgitems_txn* txn, const char* module, const char* name,
+    uint64_t value);
+
+/**
+ * Commits the transaction. All the staged items are looked up at once
+ * and if any of them does not exist or has different type than the one
+ * it has been staged with, the whole batch is rejected and no item changes.
+ * Otherwise all of them are updated (for an item staged more than once
+ * the last value wins). The transaction is released in either case.
+ *
+ * @param[in] txn Transaction started by cfgitems_txn_begin().
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+LTS_EXTERN int cfgitems_txn_commit(struct cfgitems_txn* txn);
+
+/**
+ * Releases the transaction without applying any of its updates.
+ *
+ * @param[in] txn Transaction started by cfgitems_txn_begin().
+ */
+LTS_EXTERN void cfgitems_txn_abort(struct cfgitems_txn* txn);
+
+/**
+ * Subscribes to the changes of configuration item(s). Items changed
+ * by cfgitems_set_xxx(), cfgitems_txn_commit() or by parsing configuration
+ * file are queued (without blocking the caller) and the callbacks are invoked
+ * by a dedicated dispatcher thread. Changes of an item made before the
+ * dispatcher gets to it are coalesced into a single notification.
+ * Callbacks must not (un)subscribe nor flush notifications.
+ *
+ * @param[in] module Module name the item(s) belong to
+ *                   (NULL denotes the global module).
+ * @param[in] name Name of the configuration item or "*" for all
+ *                 the items of the module.
+ * @param[in] callback Function to be called with the changed item.
+ * @param[in] ctx Argument passed to the callback as it is.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (e.g. when there is no such item or module).
+ */
+LTS_EXTERN int cfgitems_subscribe(const char* module, const char* name,
+    cfgitems_notify_callback_t callback, void* ctx);
+
+/**
+ * Cancels the subscription made by cfgitems_subscribe() with the same
+ * arguments. Once it returns the callback is not invoked any more.
+ *
+ * @param[in] module Module name the item(s) belong to
+ *                   (NULL denotes the global module).
+ * @param[in] name Name of the configuration item or "*".
+ * @param[in] callback Function passed to cfgitems_subscribe().
+ * @param[in] ctx Argument passed to cfgitems_subscribe().
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (when there is no such subscription).
+ */
+LTS_EXTERN int cfgitems_unsubscribe(const char* module, const char* name,
+    cfgitems_notify_callback_t callback, void* ctx);
+
+/**
+ * Waits until the notifications of all the changes made so far
+ * have been delivered.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (e.g. when called from a callback).
+ */
+LTS_EXTERN int cfgitems_flush_notifications(void);
+
+/**
+ * Binds the variable to 'bool' configuration item. The variable is assigned
+ * with the current value of the item at once and then with each new value
+ * (set by cfgitems_set_xxx(), cfgitems_txn_commit() or by parsing configuration
+ * file) before the update returns. The variable is written with relaxed
+ * atomic stores, so it can be read directly, even by other threads.
+ * Bindings cannot be undone, thus the variable has to outlive the item
+ * (typically it is a global one).
+ *
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] target Pointer to the variable to be bound.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (e.g. when there is no such item or its type is different).
+ */
+LTS_EXTERN int cfgitems_bind_bool(const char* module, const char* name, bool* target);
+
+/**
+ * Binds the buffer to 'string (const char*)' configuration item
+ * (see cfgitems_bind_bool()). The value is copied into the buffer,
+ * which stays valid however the item changes. The copy is made
+ * by the writer of the item, but it is not atomic: a thread reading
+ * the buffer while the item is being set by another one may see
+ * a mix of both values (use cfgitems_copy_string() there instead).
+ *
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] target Buffer to be bound.
+ * @param[in] size Size of the buffer, at least CFGITEMS_STRING_MAX.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (e.g. when there is no such item, its type is different
+ *         or the buffer is too small).
+ */
+LTS_EXTERN int cfgitems_bind_string(const char* module, const char* name, char* target, size_t size);
+
+/**
+ * Binds the variable to 'double' configuration item
+ * (see cfgitems_bind_bool()).
+ *
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] target Pointer to the variable to be bound.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (e.g. when there is no such item or its type is different).
+ */
+LTS_EXTERN int cfgitems_bind_double(const char* module, const char* name, double* target);
+
+/**
+ * Binds the variable to 's8 (int8_t)' configuration item
+ * (see cfgitems_bind_bool()).
+ *
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] target Pointer to the variable to be bound.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (e.g. when there is no such item or its type is different).
+ */
+LTS_EXTERN int cfgitems_bind_s8(const char* module, const char* name, int8_t* target);
+
+/**
+ * Binds the variable to 'u8 (uint8_t)' configuration item
+ * (see cfgitems_bind_bool()).
+ *
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] target Pointer to the variable to be bound.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (e.g. when there is no such item or its type is different).
+ */
+LTS_EXTERN int cfgitems_bind_u8(const char* module, const char* name, uint8_t* target);
+
+/**
+ * Binds the variable to 's16 (int16_t)' configuration item
+ * (see cfgitems_bind_bool()).
+ *
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] target Pointer to the variable to be bound.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (e.g. when there is no such item or its type is different).
+ */
+LTS_EXTERN int cfgitems_bind_s16(const char* module, const char* name, int16_t* target);
+
+/**
+ * Binds the variable to 'u16 (uint16_t)' configuration item
+ * (see cfgitems_bind_bool()).
+ *
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] target Pointer to the variable to be bound.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (e.g. when there is no such item or its type is different).
+ */
+LTS_EXTERN int cfgitems_bind_u16(const char* module, const char* name, uint16_t* target);
+
+/**
+ * Binds the variable to 's32 (int32_t)' configuration item
+ * (see cfgitems_bind_bool()).
+ *
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] target Pointer to the variable to be bound.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (e.g. when there is no such item or its type is different).
+ */
+LTS_EXTERN int cfgitems_bind_s32(const char* module, const char* name, int32_t* target);
+
+/**
+ * Binds the variable to 'u32 (uint32_t)' configuration item
+ * (see cfgitems_bind_bool()).
+ *
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] target Pointer to the variable to be bound.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (e.g. when there is no such item or its type is different).
+ */
+LTS_EXTERN int cfgitems_bind_u32(const char* module, const char* name, uint32_t* target);
+
+/**
+ * Binds the variable to 's64 (int64_t)' configuration item
+ * (see cfgitems_bind_bool()).
+ *
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] target Pointer to the variable to be bound.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (e.g. when there is no such item or its type is different).
+ */
+LTS_EXTERN int cfgitems_bind_s64(const char* module, const char* name, int64_t* target);
+
+/**
+ * Binds the variable to 'u64 (uint64_t)' configuration item
+ * (see cfgitems_bind_bool()).
+ *
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ * @param[in] target Pointer to the variable to be bound.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise
+ *         (e.g. when there is no such item or its type is different).
+ */
+LTS_EXTERN int cfgitems_bind_u64(const char* module, const char* name, uint64_t* target);
+
 #endif /* _CFGITEMS_H_ */
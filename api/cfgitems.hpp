@@ -0,0 +1,183 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems.hpp
+ *
+ * C++ front end of the configuration items library. Items defined
+ * in translation units which include this header carry the hash
+ * of their (module, name) key computed at compile time, and keys
+ * created with CFGITEMS_KEY() are looked up without hashing at run time.
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_HPP_
+#define _CFGITEMS_HPP_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <cstdint>
+#include <type_traits>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+#undef CFGITEMS_HASH_INITIALIZER
+#define CFGITEMS_HASH_INITIALIZER(_module_, _name_) \
+    std::integral_constant<uint32_t, ::lts::cfgitems::hash_key(_module_, _name_)>::value
+
+/*
+ * CFGITEMS_KEY() creates lts::cfgitems::key with the hash computed
+ * at compile time. Both module and name have to be string literals
+ * (or nullptr for the global module).
+ */
+#define CFGITEMS_KEY(_module_, _name_) \
+    ::lts::cfgitems::key(_module_, _name_, \
+        std::integral_constant<uint32_t, ::lts::cfgitems::hash_key(_module_, _name_)>::value)
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+namespace lts
+{
+namespace cfgitems
+{
+
+constexpr uint32_t hash_string(uint32_t h, const char* str)
+{
+    do {
+        h ^= static_cast<unsigned char>(*str);
+        h *= CFGITEMS_HASH_PRIME;
+    } while (*str++ != '\0');
+
+    return h;
+}
+
+constexpr uint32_t hash_final(uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+
+    return h;
+}
+
+/*
+ * Computes the very same hash as the library does at run time.
+ */
+constexpr uint32_t hash_key(const char* module, const char* name)
+{
+    return hash_final(hash_string(hash_string(CFGITEMS_HASH_OFFSET_BASIS,
+        module ? module : CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE)), name));
+}
+
+struct key
+{
+    constexpr key(const char* module, const char* name, uint32_t hash) :
+        module{module ? module : CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE)},
+        name{name},
+        hash{hash}
+    {
+    }
+
+    const char* module;
+    const char* name;
+    uint32_t hash;
+};
+
+template<typename T>
+struct traits;
+
+#define CFGITEMS_TRAITS(_ctype_, _type_, _suffix_)                                  \
+    template<>                                                                      \
+    struct traits<_ctype_>                                                          \
+    {                                                                               \
+        static constexpr enum cfgitems_type type = CFGITEMS_TYPE_ ## _type_;        \
+        static int get(cfgitems_handle_t handle, _ctype_* value)                    \
+            { return cfgitems_get_ ## _suffix_ ## _h(handle, value); }              \
+        static int set(cfgitems_handle_t handle, _ctype_ value)                     \
+            { return cfgitems_set_ ## _suffix_ ## _h(handle, value); }              \
+    }
+
+CFGITEMS_TRAITS(bool,        BOOL,   bool);
+CFGITEMS_TRAITS(const char*, STRING, string);
+CFGITEMS_TRAITS(double,      DOUBLE, double);
+CFGITEMS_TRAITS(int8_t,      S8,     s8);
+CFGITEMS_TRAITS(uint8_t,     U8,     u8);
+CFGITEMS_TRAITS(int16_t,     S16,    s16);
+CFGITEMS_TRAITS(uint16_t,    U16,    u16);
+CFGITEMS_TRAITS(int32_t,     S32,    s32);
+CFGITEMS_TRAITS(uint32_t,    U32,    u32);
+CFGITEMS_TRAITS(int64_t,     S64,    s64);
+CFGITEMS_TRAITS(uint64_t,    U64,    u64);
+
+#undef CFGITEMS_TRAITS
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/**
+ * Looks up configuration item of type T.
+ *
+ * @param[in] k Key of the configuration item (see CFGITEMS_KEY()).
+ * @param[out] handle Pointer to the variable which will be assigned
+ *                    with the handle of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+template<typename T>
+inline int lookup(const key& k, cfgitems_handle_t* handle)
+{
+    return cfgitems_lookup_hashed(k.module, k.name, k.hash, traits<T>::type, handle);
+}
+
+/**
+ * Gets value of configuration item of type T.
+ *
+ * @param[in] k Key of the configuration item (see CFGITEMS_KEY()).
+ * @param[out] value Pointer to the variable which will be assigned
+ *                   with the value of configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+template<typename T>
+inline int get(const key& k, T* value)
+{
+    cfgitems_handle_t handle;
+
+    if (lookup<T>(k, &handle) != CFGITEMS_SUCCESS)
+        return CFGITEMS_FAILURE;
+
+    return traits<T>::get(handle, value);
+}
+
+/**
+ * Sets value of configuration item of type T.
+ *
+ * @param[in] k Key of the configuration item (see CFGITEMS_KEY()).
+ * @param[in] value Value of the configuration item.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+template<typename T>
+inline int set(const key& k, T value)
+{
+    cfgitems_handle_t handle;
+
+    if (lookup<T>(k, &handle) != CFGITEMS_SUCCESS)
+        return CFGITEMS_FAILURE;
+
+    return traits<T>::set(handle, value);
+}
+
+} /* namespace cfgitems */
+} /* namespace lts */
+
+#endif /* _CFGITEMS_HPP_ */
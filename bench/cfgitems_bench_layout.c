@@ -0,0 +1,228 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_bench_layout.c
+ *
+ * Compares reading values of many items stored in the former layout
+ * (value embedded in 'struct cfgitems') with reading them from
+ * the dense values section (as CFGITEMS_GET() does).
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+#define CACHE_LINE_SIZE 64
+#define PASSES 16
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+/* layout of 'struct cfgitems' before values were moved out of it */
+struct cfgitems_embedded
+{
+    const char* module;
+    enum cfgitems_type type;
+    uint32_t hash;
+    const char* name;
+    union cfgitems_any value;
+    char strvalue[128];
+} __attribute__((aligned(CFGITEMS_ALIGN)));
+
+struct measurement
+{
+    double ns; /* per item read */
+    long long misses; /* per pass, negative when not available */
+};
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static int perf_open(void);
+static struct measurement bench_embedded(const struct cfgitems_embedded* items, size_t n, int fd);
+static struct measurement bench_dense(const union cfgitems_any* values, size_t n, int fd);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+static volatile uint64_t sink;
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+static inline double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static inline void perf_start(int fd)
+{
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+static inline long long perf_stop(int fd)
+{
+    long long count = -1;
+
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &count, sizeof(count)) != sizeof(count))
+            count = -1;
+    }
+
+    return count;
+}
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+int main(int argc, char* argv[])
+{
+    static const size_t sizes[] = {1000, 100000, 1000000};
+    int fd = perf_open();
+
+    printf("bytes per item: embedded %zu, split %zu (hot %zu + cold %zu)\n",
+        sizeof(struct cfgitems_embedded),
+        sizeof(union cfgitems_any) + sizeof(struct cfgitems),
+        sizeof(union cfgitems_any), sizeof(struct cfgitems));
+    printf("cache lines per %d items read: embedded %zu, split %zu\n", CACHE_LINE_SIZE,
+        (CACHE_LINE_SIZE * sizeof(struct cfgitems_embedded) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE,
+        (CACHE_LINE_SIZE * sizeof(union cfgitems_any) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE);
+    if (fd < 0)
+        printf("cache misses: not available (perf_event_open() failed)\n");
+
+    printf("%10s %16s %16s %18s %18s\n",
+        "items", "embedded [ns]", "split [ns]", "embedded misses", "split misses");
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        size_t n = sizes[i];
+        struct cfgitems_embedded* items;
+        union cfgitems_any* values;
+
+        items = aligned_alloc(CFGITEMS_ALIGN, n * sizeof(struct cfgitems_embedded));
+        values = aligned_alloc(CACHE_LINE_SIZE,
+            (n * sizeof(union cfgitems_any) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE);
+        if ((items == NULL) || (values == NULL)) {
+            fprintf(stderr, "failed to allocate %zu items\n", n);
+            return EXIT_FAILURE;
+        }
+
+        memset(items, 0, n * sizeof(struct cfgitems_embedded));
+        for (size_t j = 0; j < n; ++j) {
+            items[j].type = CFGITEMS_TYPE_U64;
+            items[j].value._U64_ = j;
+            values[j]._U64_ = j;
+        }
+
+        struct measurement e = bench_embedded(items, n, fd);
+        struct measurement d = bench_dense(values, n, fd);
+
+        printf("%10zu %16.2f %16.2f ", n, e.ns, d.ns);
+        if ((e.misses >= 0) && (d.misses >= 0))
+            printf("%18lld %18lld\n", e.misses, d.misses);
+        else
+            printf("%18s %18s\n", "n/a", "n/a");
+
+        free(values);
+        free(items);
+    }
+
+    if (fd >= 0)
+        close(fd);
+
+    return EXIT_SUCCESS;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+static int perf_open(void)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static struct measurement bench_embedded(const struct cfgitems_embedded* items, size_t n, int fd)
+{
+    struct measurement m;
+    uint64_t sum = 0;
+    double start;
+
+    perf_start(fd);
+    start = now();
+
+    for (int pass = 0; pass < PASSES; ++pass)
+        for (size_t i = 0; i < n; ++i)
+            sum += items[i].value._U64_;
+
+    m.ns = (now() - start) / ((double)n * PASSES);
+    m.misses = perf_stop(fd);
+    if (m.misses > 0)
+        m.misses /= PASSES;
+
+    sink = sum;
+
+    return m;
+}
+
+static struct measurement bench_dense(const union cfgitems_any* values, size_t n, int fd)
+{
+    struct measurement m;
+    uint64_t sum = 0;
+    double start;
+
+    perf_start(fd);
+    start = now();
+
+    for (int pass = 0; pass < PASSES; ++pass)
+        for (size_t i = 0; i < n; ++i)
+            sum += values[i]._U64_;
+
+    m.ns = (now() - start) / ((double)n * PASSES);
+    m.misses = perf_stop(fd);
+    if (m.misses > 0)
+        m.misses /= PASSES;
+
+    sink = sum;
+
+    return m;
+}
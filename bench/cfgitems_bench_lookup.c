@@ -0,0 +1,338 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_bench_lookup.c
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <cfgitems_hash.h>
+#include <cfgitems_eytzinger.h>
+#include <cfgitems_bloom.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+#define ITEMS_PER_MODULE 100
+#define MIN_LOOKUPS (1 << 20)
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+struct registry
+{
+    size_t n;
+    struct cfgitems* items;
+    struct cfgitems** sorted;
+    struct cfgitems_hash_slot* hash;
+    size_t hash_size;
+    struct cfgitems_hash_slot* eytzinger;
+    size_t eytzinger_size;
+    uint32_t* bloom;
+    size_t bloom_size;
+    char** keys; /* module and name of each item, as separate copies */
+    char** absent; /* module and name of keys which are not there */
+    size_t* order; /* order in which items are looked up */
+};
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static int registry_create(struct registry* r, size_t n);
+static void registry_destroy(struct registry* r);
+static double bench_binary_search(const struct registry* r, size_t lookups);
+static double bench_hash(const struct registry* r, size_t lookups);
+static double bench_eytzinger(const struct registry* r, size_t lookups);
+static double bench_misses(const struct registry* r, size_t lookups, bool bloom, bool eytzinger);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+static volatile uintptr_t sink;
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+static inline double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* the very same ordering as used by the library */
+static inline int compare(const struct cfgitems* l, const struct cfgitems* r)
+{
+    int status;
+
+    status = strcmp(l->module, r->module);
+    if (status) {
+        if (!strcmp(l->module, CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE)))
+            return -1;
+        else
+        if (!strcmp(r->module, CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE)))
+            return +1;
+        else
+            return status;
+    }
+
+    return strcmp(l->name, r->name);
+}
+
+static int compare_qsort(const void* l, const void* r)
+{
+    return compare(*(struct cfgitems* const*)l, *(struct cfgitems* const*)r);
+}
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+int main(int argc, char* argv[])
+{
+    static const size_t sizes[] = {100, 10000, 1000000};
+
+    printf("%10s %12s %22s %22s %22s\n",
+        "items", "lookups", "binary search [ns]", "hash [ns]", "eytzinger [ns]");
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        struct registry r;
+        size_t lookups = sizes[i] > MIN_LOOKUPS ? sizes[i] : MIN_LOOKUPS;
+
+        if (registry_create(&r, sizes[i]) != 0) {
+            fprintf(stderr, "failed to create registry of %zu items\n", sizes[i]);
+            return EXIT_FAILURE;
+        }
+
+        double bs = bench_binary_search(&r, lookups);
+        double h = bench_hash(&r, lookups);
+        double e = bench_eytzinger(&r, lookups);
+
+        printf("%10zu %12zu %22.1f %22.1f %22.1f\n", sizes[i], lookups, bs, h, e);
+
+        registry_destroy(&r);
+    }
+
+    printf("\nlook ups of absent keys\n");
+    printf("%10s %12s %22s %22s %22s %22s\n", "items", "lookups",
+        "hash [ns]", "bloom + hash [ns]", "eytzinger [ns]", "bloom + eytzinger [ns]");
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        struct registry r;
+        size_t lookups = sizes[i] > MIN_LOOKUPS ? sizes[i] : MIN_LOOKUPS;
+
+        if (registry_create(&r, sizes[i]) != 0) {
+            fprintf(stderr, "failed to create registry of %zu items\n", sizes[i]);
+            return EXIT_FAILURE;
+        }
+
+        double h = bench_misses(&r, lookups, false, false);
+        double bh = bench_misses(&r, lookups, true, false);
+        double e = bench_misses(&r, lookups, false, true);
+        double be = bench_misses(&r, lookups, true, true);
+
+        printf("%10zu %12zu %22.1f %22.1f %22.1f %22.1f\n", sizes[i], lookups, h, bh, e, be);
+
+        registry_destroy(&r);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+static int registry_create(struct registry* r, size_t n)
+{
+    char buf[64];
+
+    memset(r, 0, sizeof(*r));
+
+    r->n = n;
+    r->items = calloc(n, sizeof(struct cfgitems));
+    r->sorted = calloc(n, sizeof(struct cfgitems*));
+    r->hash_size = cfgitems_hash_size(n);
+    r->hash = calloc(r->hash_size, sizeof(struct cfgitems_hash_slot));
+    r->eytzinger_size = cfgitems_eytzinger_size(n);
+    r->eytzinger = aligned_alloc(64, (r->eytzinger_size * sizeof(struct cfgitems_hash_slot) + 63) / 64 * 64);
+    r->bloom_size = cfgitems_bloom_words(n);
+    r->bloom = calloc(r->bloom_size, sizeof(uint32_t));
+    r->keys = calloc(2 * n, sizeof(char*));
+    r->absent = calloc(2 * n, sizeof(char*));
+    r->order = calloc(n, sizeof(size_t));
+    if (!r->items || !r->sorted || !r->hash || !r->eytzinger || !r->bloom || !r->keys ||
+        !r->absent || !r->order)
+        return -1;
+
+    for (size_t i = 0; i < n; ++i) {
+        snprintf(buf, sizeof(buf), "module%zu", i / ITEMS_PER_MODULE);
+        r->items[i].module = strdup(buf);
+        r->keys[2 * i + 0] = strdup(buf);
+        snprintf(buf, sizeof(buf), "item%zu", i);
+        r->items[i].name = strdup(buf);
+        r->keys[2 * i + 1] = strdup(buf);
+        snprintf(buf, sizeof(buf), "module%zu", i / ITEMS_PER_MODULE);
+        r->absent[2 * i + 0] = strdup(buf);
+        snprintf(buf, sizeof(buf), "absent%zu", i);
+        r->absent[2 * i + 1] = strdup(buf);
+        r->items[i].type = CFGITEMS_TYPE_U32;
+        r->sorted[i] = &r->items[i];
+        r->order[i] = i;
+    }
+
+    qsort(r->sorted, n, sizeof(struct cfgitems*), compare_qsort);
+
+    for (size_t i = 0; i < n; ++i)
+        cfgitems_hash_insert(r->hash, r->hash_size,
+            cfgitems_hash_key(r->items[i].module, r->items[i].name), i);
+
+    for (size_t i = 0; i < n; ++i)
+        cfgitems_bloom_add(r->bloom, r->bloom_size,
+            cfgitems_hash_key(r->items[i].module, r->items[i].name));
+
+    struct cfgitems_hash_slot* entries = calloc(n, sizeof(struct cfgitems_hash_slot));
+    if (entries == NULL)
+        return -1;
+    for (size_t i = 0; i < n; ++i) {
+        entries[i].hash = cfgitems_hash_key(r->items[i].module, r->items[i].name);
+        entries[i].id = i + 1;
+    }
+    cfgitems_eytzinger_build(r->eytzinger, entries, n);
+    free(entries);
+
+    srand(n);
+    for (size_t i = n - 1; i > 0; --i) {
+        size_t j = (size_t)rand() % (i + 1);
+        size_t t = r->order[i];
+        r->order[i] = r->order[j];
+        r->order[j] = t;
+    }
+
+    return 0;
+}
+
+static void registry_destroy(struct registry* r)
+{
+    for (size_t i = 0; i < r->n; ++i) {
+        free((void*)r->items[i].module);
+        free((void*)r->items[i].name);
+        free(r->keys[2 * i + 0]);
+        free(r->keys[2 * i + 1]);
+        free(r->absent[2 * i + 0]);
+        free(r->absent[2 * i + 1]);
+    }
+
+    free(r->items);
+    free(r->sorted);
+    free(r->hash);
+    free(r->eytzinger);
+    free(r->bloom);
+    free(r->keys);
+    free(r->absent);
+    free(r->order);
+}
+
+static double bench_binary_search(const struct registry* r, size_t lookups)
+{
+    double start = now();
+
+    for (size_t i = 0; i < lookups; ++i) {
+        size_t k = r->order[i % r->n];
+        const struct cfgitems x = {.module = r->keys[2 * k + 0], .name = r->keys[2 * k + 1]};
+        size_t lo = 0;
+        size_t hi = r->n;
+        struct cfgitems* found = NULL;
+
+        while (lo < hi) {
+            size_t m = (lo + hi) / 2;
+            int status = compare(r->sorted[m], &x);
+
+            if (status < 0)
+                lo = m + 1;
+            else
+            if (status > 0)
+                hi = m;
+            else {
+                found = r->sorted[m];
+                break;
+            }
+        }
+
+        sink = (uintptr_t)found;
+    }
+
+    return (now() - start) / lookups;
+}
+
+static double bench_hash(const struct registry* r, size_t lookups)
+{
+    double start = now();
+
+    for (size_t i = 0; i < lookups; ++i) {
+        size_t k = r->order[i % r->n];
+        const char* module = r->keys[2 * k + 0];
+        const char* name = r->keys[2 * k + 1];
+
+        sink = (uintptr_t)cfgitems_hash_find(r->hash, r->hash_size, r->items,
+            cfgitems_hash_key(module, name), module, name);
+    }
+
+    return (now() - start) / lookups;
+}
+
+static double bench_eytzinger(const struct registry* r, size_t lookups)
+{
+    double start = now();
+
+    for (size_t i = 0; i < lookups; ++i) {
+        size_t k = r->order[i % r->n];
+        const char* module = r->keys[2 * k + 0];
+        const char* name = r->keys[2 * k + 1];
+
+        sink = (uintptr_t)cfgitems_eytzinger_find(r->eytzinger, r->eytzinger_size, r->items,
+            cfgitems_hash_key(module, name), module, name);
+    }
+
+    return (now() - start) / lookups;
+}
+
+static double bench_misses(const struct registry* r, size_t lookups, bool bloom, bool eytzinger)
+{
+    double start = now();
+
+    for (size_t i = 0; i < lookups; ++i) {
+        size_t k = r->order[i % r->n];
+        const char* module = r->absent[2 * k + 0];
+        const char* name = r->absent[2 * k + 1];
+        uint32_t hash = cfgitems_hash_key(module, name);
+
+        if (bloom && !cfgitems_bloom_test(r->bloom, r->bloom_size, hash))
+            sink = 0;
+        else
+        if (eytzinger)
+            sink = (uintptr_t)cfgitems_eytzinger_find(r->eytzinger, r->eytzinger_size, r->items,
+                hash, module, name);
+        else
+            sink = (uintptr_t)cfgitems_hash_find(r->hash, r->hash_size, r->items,
+                hash, module, name);
+    }
+
+    return (now() - start) / lookups;
+}
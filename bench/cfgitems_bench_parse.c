@@ -0,0 +1,381 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_bench_parse.c
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <cfgitems_scan.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+#define FILE_SIZE (32 << 20)
+#define MODULES 8
+#define PASSES 5
+#define LOADS 10000
+
+#define DEFINE_MODULE(_module_)                                  \
+    CFGITEMS_DEFINE_BOOL(_module_, enabled, false);              \
+    CFGITEMS_DEFINE_STRING(_module_, path, "/tmp");              \
+    CFGITEMS_DEFINE_DOUBLE(_module_, ratio, 0.0);                \
+    CFGITEMS_DEFINE_S32(_module_, offset, 0);                    \
+    CFGITEMS_DEFINE_U32(_module_, count, 0);                     \
+    CFGITEMS_DEFINE_U64(_module_, limit, 0)
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+DEFINE_MODULE(module0);
+DEFINE_MODULE(module1);
+DEFINE_MODULE(module2);
+DEFINE_MODULE(module3);
+DEFINE_MODULE(module4);
+DEFINE_MODULE(module5);
+DEFINE_MODULE(module6);
+DEFINE_MODULE(module7);
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static size_t generate(FILE* fp, size_t size);
+static double scan(cfgitems_scan_t tokenizer, const char* buf, size_t size);
+static size_t generate_modules(char* buf, size_t size);
+static double reparse(char* buf, size_t size, int changes);
+static void touch_modules(unsigned value);
+static void load(const char* compiler);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+static const struct {
+    enum cfgitems_scan_isa isa;
+    const char* name;
+} tokenizers[] = {
+    {CFGITEMS_SCAN_SCALAR, "scalar"},
+    {CFGITEMS_SCAN_SSE2, "sse2"},
+    {CFGITEMS_SCAN_AVX2, "avx2"},
+};
+
+/* what changes before each of the re-parses */
+enum {
+    CHANGES_ALL,
+    CHANGES_NONE,
+    CHANGES_ONE_SECTION,
+};
+
+static const struct {
+    int changes;
+    const char* name;
+} reparses[] = {
+    {CHANGES_ALL, "all"},
+    {CHANGES_NONE, "none"},
+    {CHANGES_ONE_SECTION, "one section"},
+};
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+static inline double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+int main(int argc, char* argv[])
+{
+    char filename[] = "/tmp/cfgitems_bench_parse_XXXXXX";
+    double best = 0.0;
+    size_t size;
+    char* buf;
+    FILE* fp;
+    int fd;
+
+    if (cfgitems_init(NULL) != CFGITEMS_SUCCESS) {
+        fprintf(stderr, "failed to initialize configuration items\n");
+        return EXIT_FAILURE;
+    }
+
+    fd = mkstemp(filename);
+    if ((fd < 0) || ((fp = fdopen(fd, "w")) == NULL)) {
+        fprintf(stderr, "failed to create configuration file\n");
+        return EXIT_FAILURE;
+    }
+
+    size = generate(fp, FILE_SIZE);
+    fclose(fp);
+
+    for (int pass = 0; pass < PASSES; ++pass) {
+        double start = now();
+
+        if (cfgitems_parse(filename) != CFGITEMS_SUCCESS) {
+            fprintf(stderr, "failed to parse configuration file\n");
+            unlink(filename);
+            return EXIT_FAILURE;
+        }
+
+        double mbps = size / ((now() - start) / 1e9) / (1 << 20);
+        if (mbps > best)
+            best = mbps;
+    }
+
+    /* tokenizers alone, on the very same configuration */
+    buf = malloc(size);
+    if ((buf == NULL) || ((fp = fopen(filename, "r")) == NULL) || (fread(buf, 1, size, fp) != size)) {
+        fprintf(stderr, "failed to read configuration file\n");
+        unlink(filename);
+        return EXIT_FAILURE;
+    }
+    fclose(fp);
+
+    unlink(filename);
+
+    printf("%12s %14s\n", "size [MB]", "parse [MB/s]");
+    printf("%12.1f %14.1f\n", (double)size / (1 << 20), best);
+
+    printf("\n%12s %14s\n", "tokenizer", "scan [MB/s]");
+    for (size_t i = 0; i < sizeof(tokenizers) / sizeof(tokenizers[0]); ++i) {
+        cfgitems_scan_t tokenizer = cfgitems_scan_get(tokenizers[i].isa);
+        if (tokenizer == NULL)
+            printf("%12s %14s\n", tokenizers[i].name, "n/a");
+        else
+            printf("%12s %14.1f\n", tokenizers[i].name, scan(tokenizer, buf, size));
+    }
+
+    /* re-parses of a configuration with a (large) section of each module */
+    size = generate_modules(buf, size);
+
+    printf("\n%12s %14s\n", "changed", "parse [MB/s]");
+    for (size_t i = 0; i < sizeof(reparses) / sizeof(reparses[0]); ++i)
+        printf("%12s %14.1f\n", reparses[i].name, reparse(buf, size, reparses[i].changes));
+
+    free(buf);
+
+    /* text against compiled configuration, given cfgitems-compile */
+    if (argc > 1)
+        load(argv[1]);
+
+    return EXIT_SUCCESS;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * Best throughput of the tokenizer (in MB/s) over PASSES passes.
+ */
+static double scan(cfgitems_scan_t tokenizer, const char* buf, size_t size)
+{
+    struct cfgitems_token tokens[64];
+    volatile size_t n_tokens = 0;
+    double best = 0.0;
+
+    for (int pass = 0; pass < PASSES; ++pass) {
+        struct cfgitems_scanner scanner;
+        double start = now();
+        size_t n;
+
+        cfgitems_scanner_init(&scanner, buf, size);
+        while ((n = tokenizer(&scanner, tokens, 64)) > 0)
+            n_tokens += n;
+
+        double mbps = size / ((now() - start) / 1e9) / (1 << 20);
+        if (mbps > best)
+            best = mbps;
+    }
+
+    return best;
+}
+
+/*
+ * Writes a configuration file the way generators do: many sections,
+ * each with comments, our own items and (more of) keys of other programs,
+ * some of them within sections we do not know at all.
+ */
+static size_t generate(FILE* fp, size_t size)
+{
+    size_t written = 0;
+
+    for (unsigned k = 0; written < size; ++k) {
+        int n = 0;
+
+        if (k % 4 == 3)
+            n += fprintf(fp, "\n[othermodule%u]\n", k);
+        else
+            n += fprintf(fp, "\n[module%u]\n", k % MODULES);
+
+        n += fprintf(fp, "; generated section %u\n", k);
+        n += fprintf(fp, "enabled = %s\n", k & 1 ? "true" : "off");
+        n += fprintf(fp, "path = \"/var/lib/service/%u/data\"\n", k);
+        n += fprintf(fp, "ratio = %u.%03u\n", k % 100, k % 1000);
+        n += fprintf(fp, "offset = -%u\n", k % 100000);
+        n += fprintf(fp, "count = %u\n", k);
+        n += fprintf(fp, "limit = 0x%x\n", k * 4096);
+
+        for (unsigned i = 0; i < 8; ++i)
+            n += fprintf(fp, "    unrelated_key_%u = value_of_another_program_%u\n", i, k + i);
+
+        written += n;
+    }
+
+    return written;
+}
+
+/*
+ * Writes a configuration with one section of each module (of about
+ * the same size) into the buffer.
+ */
+static size_t generate_modules(char* buf, size_t size)
+{
+    size_t written = 0;
+
+    for (unsigned m = 0; m < MODULES; ++m) {
+        size_t end = (m + 1) * (size / MODULES);
+
+        written += sprintf(buf + written, "[module%u]\n", m);
+        written += sprintf(buf + written, "enabled = on\n");
+        written += sprintf(buf + written, "path = \"/var/lib/service/%u/data\"\n", m);
+        written += sprintf(buf + written, "ratio = 0.%u\n", m);
+        written += sprintf(buf + written, "offset = -%u\n", m);
+        written += sprintf(buf + written, "count = 10\n");
+        written += sprintf(buf + written, "limit = 0x%x\n", m * 4096);
+
+        for (unsigned i = 0; written + 128 < end; ++i)
+            written += sprintf(buf + written, "unrelated_key_%u = value_of_another_program_%u\n", i, m);
+    }
+
+    return written;
+}
+
+/*
+ * Best throughput of re-parses (in MB/s) of the configuration
+ * generated by generate_modules() over PASSES passes.
+ */
+static double reparse(char* buf, size_t size, int changes)
+{
+    char* count = strstr(strstr(buf, "[module3]"), "count = ") + strlen("count = ");
+    double best = 0.0;
+
+    cfgitems_parse_buffer(buf, size);
+
+    for (int pass = 0; pass < PASSES; ++pass) {
+        if (changes == CHANGES_ALL)
+            touch_modules(pass);
+        else
+        if (changes == CHANGES_ONE_SECTION)
+            *count = (*count == '1') ? '2' : '1';
+
+        double start = now();
+
+        cfgitems_parse_buffer(buf, size);
+
+        double mbps = size / ((now() - start) / 1e9) / (1 << 20);
+        if (mbps > best)
+            best = mbps;
+    }
+
+    return best;
+}
+
+/*
+ * Writes an item of each module, so that none of their sections
+ * is skipped by the next parse.
+ */
+static void touch_modules(unsigned value)
+{
+    for (unsigned m = 0; m < MODULES; ++m) {
+        char module[16];
+        snprintf(module, sizeof(module), "module%u", m);
+        cfgitems_set_u32(module, "count", value);
+    }
+}
+
+/*
+ * Average time of applying values of all the items from the configuration
+ * file and from the very configuration compiled by cfgitems-compile.
+ */
+static void load(const char* compiler)
+{
+    char source[] = "/tmp/cfgitems_bench_parse_XXXXXX";
+    char image[sizeof(source) + 4];
+    char executable[4096];
+    char command[2 * sizeof(executable)];
+    double parse_ns = 0.0;
+    double load_ns = 0.0;
+    ssize_t len;
+    FILE* fp;
+    int fd;
+
+    len = readlink("/proc/self/exe", executable, sizeof(executable) - 1);
+    fd = mkstemp(source);
+    if ((len < 0) || (fd < 0) || ((fp = fdopen(fd, "w")) == NULL)) {
+        fprintf(stderr, "failed to create configuration file\n");
+        return;
+    }
+    executable[len] = '\0';
+
+    for (unsigned m = 0; m < MODULES; ++m) {
+        fprintf(fp, "[module%u]\n", m);
+        fprintf(fp, "enabled = on\n");
+        fprintf(fp, "path = \"/var/lib/service/%u/data\"\n", m);
+        fprintf(fp, "ratio = 0.%u\n", m);
+        fprintf(fp, "offset = -%u\n", m);
+        fprintf(fp, "count = %u\n", m);
+        fprintf(fp, "limit = 0x%x\n", m * 4096);
+    }
+    fclose(fp);
+
+    snprintf(image, sizeof(image), "%s.bin", source);
+    if ((snprintf(command, sizeof(command), "'%s' '%s' '%s' '%s'",
+            compiler, executable, source, image) >= (int)sizeof(command)) ||
+        (system(command) != 0)) {
+        fprintf(stderr, "failed to compile configuration file\n");
+        unlink(source);
+        return;
+    }
+
+    for (unsigned i = 0; i < LOADS; ++i) {
+        double start;
+
+        touch_modules(i);
+        start = now();
+        cfgitems_parse(source);
+        parse_ns += now() - start;
+
+        touch_modules(i);
+        start = now();
+        cfgitems_load_compiled(image);
+        load_ns += now() - start;
+    }
+
+    unlink(source);
+    unlink(image);
+
+    printf("\n%12s %14s\n", "items from", "apply [us]");
+    printf("%12s %14.2f\n", "text", parse_ns / LOADS / 1e3);
+    printf("%12s %14.2f\n", "compiled", load_ns / LOADS / 1e3);
+}
@@ -0,0 +1,61 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_bind.h
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_BIND_H_
+#define _CFGITEMS_BIND_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+/*
+ * Variable bound to an item (see cfgitems_bind_xxx()). Bindings of each
+ * item form a list, which only grows, so writers can walk it without
+ * any lock.
+ */
+struct cfgitems_binding
+{
+    struct cfgitems_binding* next;
+    void* target;
+    size_t size; /* of the buffer strings are copied into */
+};
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * function forward declarations (external linkage)
+\*===========================================================================*/
+/**
+ * Writes the value of the item through to the variables bound to it
+ * (if there are any). Has to be called by the writer of the item,
+ * between cfgitems_write_begin() and cfgitems_write_end(), so that
+ * concurrent writers of the item cannot leave the variables
+ * with the older value.
+ *
+ * @param[in] cfgitem Configuration item which has just been written.
+ */
+void cfgitems_bind_update(const struct cfgitems* cfgitem);
+
+#endif /* _CFGITEMS_BIND_H_ */
@@ -0,0 +1,86 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_bloom.h
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_BLOOM_H_
+#define _CFGITEMS_BLOOM_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+/*
+ * Bloom filter over the hashes of the items' keys. It is blocked:
+ * the hash selects one 32-bit word (by its high bits) and three bits
+ * within that word (by its low bits), so that testing a key touches
+ * a single word. With 16 bits per item about 1% of the keys which
+ * are not there pass the filter.
+ */
+#define CFGITEMS_BLOOM_BITS_PER_ITEM 16
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * Number of 32-bit words of the filter over n items (never zero).
+ */
+static inline size_t cfgitems_bloom_words(size_t n)
+{
+    return n * CFGITEMS_BLOOM_BITS_PER_ITEM / 32 + 1;
+}
+
+static inline uint32_t cfgitems_bloom_mask(uint32_t hash)
+{
+    return (1u << (hash & 31)) | (1u << ((hash >> 5) & 31)) | (1u << ((hash >> 10) & 31));
+}
+
+static inline size_t cfgitems_bloom_word(uint32_t hash, size_t size)
+{
+    return (size_t)(((uint64_t)hash * size) >> 32);
+}
+
+/*
+ * Adds the hash of the item's key to the filter (array of 'size' words).
+ */
+static inline void cfgitems_bloom_add(uint32_t* filter, size_t size, uint32_t hash)
+{
+    filter[cfgitems_bloom_word(hash, size)] |= cfgitems_bloom_mask(hash);
+}
+
+/*
+ * @return false when the key with the hash is certainly not in the filter,
+ *         true when it might be.
+ */
+static inline bool cfgitems_bloom_test(const uint32_t* filter, size_t size, uint32_t hash)
+{
+    uint32_t mask = cfgitems_bloom_mask(hash);
+
+    return (filter[cfgitems_bloom_word(hash, size)] & mask) == mask;
+}
+
+/*===========================================================================*\
+ * global (external linkage) object declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * function forward declarations (external linkage)
+\*===========================================================================*/
+
+#endif /* _CFGITEMS_BLOOM_H_ */
@@ -0,0 +1,142 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_cache.h
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_CACHE_H_
+#define _CFGITEMS_CACHE_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+/* number of entries of the (direct-mapped) cache, has to be a power of 2 */
+#define CFGITEMS_CACHE_SIZE 16
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+/*
+ * Entry of the look up cache. It is keyed by the pointers passed by the caller
+ * (typically string literals) and is valid only for the index 'generation'
+ * it was filled with.
+ */
+struct cfgitems_cache_entry
+{
+    const char* module;
+    const char* name;
+    struct cfgitems* cfgitem;
+    uint32_t generation;
+};
+
+/*
+ * Hits and misses of the cache of a thread, written only by the thread
+ * and read by anybody (see cfgitems_cache_stats()). Records are never freed,
+ * those of exited threads are reused (and counted on) by the new ones.
+ */
+struct cfgitems_cache_record
+{
+    uint64_t hits;
+    uint64_t misses;
+    struct cfgitems_cache_record* next;
+    int active;
+} __attribute__((aligned(64)));
+
+struct cfgitems_cache
+{
+    struct cfgitems_cache_entry entries[CFGITEMS_CACHE_SIZE];
+    struct cfgitems_cache_record* record; /* NULL until it has been obtained */
+};
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * Counts in the record of the thread. There is no other writer,
+ * so no atomic read-modify-write is needed.
+ */
+static inline void cfgitems_cache_count(uint64_t* counter)
+{
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+}
+
+static inline struct cfgitems_cache_entry* cfgitems_cache_entry(struct cfgitems_cache* cache,
+    const char* module, const char* name)
+{
+    uintptr_t key = (uintptr_t)module * 31 + (uintptr_t)name;
+
+    return &cache->entries[(key >> 3) & (CFGITEMS_CACHE_SIZE - 1)];
+}
+
+/*
+ * Looks up the item in the cache. Pointers alone are not enough,
+ * as the caller may reuse the same buffer for another key, so the key
+ * of the cached item is compared as well (which is still much cheaper
+ * than hashing it).
+ *
+ * @return Pointer to the cached item or NULL if there is no such item in the cache.
+ */
+static inline struct cfgitems* cfgitems_cache_find(struct cfgitems_cache* cache,
+    uint32_t generation, const char* module, const char* name)
+{
+    const struct cfgitems_cache_entry* e = cfgitems_cache_entry(cache, module, name);
+
+    if ((e->module == module) && (e->name == name) && (e->generation == generation) &&
+        (e->cfgitem != NULL) && !strcmp(e->cfgitem->name, name) && !strcmp(e->cfgitem->module, module)) {
+        if (cache->record != NULL)
+            cfgitems_cache_count(&cache->record->hits);
+        return e->cfgitem;
+    }
+
+    if (cache->record != NULL)
+        cfgitems_cache_count(&cache->record->misses);
+
+    return NULL;
+}
+
+static inline void cfgitems_cache_insert(struct cfgitems_cache* cache,
+    uint32_t generation, const char* module, const char* name, struct cfgitems* cfgitem)
+{
+    struct cfgitems_cache_entry* e = cfgitems_cache_entry(cache, module, name);
+
+    e->module = module;
+    e->name = name;
+    e->cfgitem = cfgitem;
+    e->generation = generation;
+}
+
+/*===========================================================================*\
+ * global (external linkage) object declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * function forward declarations (external linkage)
+\*===========================================================================*/
+/**
+ * Gets the record the calling thread counts its hits and misses in.
+ *
+ * @return The record or NULL if it could not be allocated.
+ */
+struct cfgitems_cache_record* cfgitems_cache_record(void);
+
+/**
+ * Sums up the hits and misses of all the threads.
+ *
+ * @param[out] stats Statistics of all the threads.
+ */
+void cfgitems_cache_stats(struct cfgitems_cache_stats* stats);
+
+#endif /* _CFGITEMS_CACHE_H_ */
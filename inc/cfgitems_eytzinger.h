@@ -0,0 +1,94 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_eytzinger.h
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_EYTZINGER_H_
+#define _CFGITEMS_EYTZINGER_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <cfgitems_hash.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * Number of slots of the Eytzinger array over n items.
+ * Slot 0 is not used, so that children of slot k are 2k and 2k + 1.
+ */
+static inline size_t cfgitems_eytzinger_size(size_t n)
+{
+    return n + 1;
+}
+
+/*===========================================================================*\
+ * global (external linkage) object declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * function forward declarations (external linkage)
+\*===========================================================================*/
+/**
+ * Lays out (hash, id) pairs in Eytzinger (breadth first) order of the
+ * implicit binary search tree over them, ordered by hash.
+ *
+ * @param[out] table Eytzinger array of cfgitems_eytzinger_size(n) slots.
+ * @param[in,out] entries Pairs to be laid out ('id' already increased by one).
+ *                        The array is sorted in place.
+ * @param[in] n Number of pairs.
+ */
+void cfgitems_eytzinger_build(struct cfgitems_hash_slot* table,
+    struct cfgitems_hash_slot* entries, size_t n);
+
+/**
+ * Looks up the item in the Eytzinger array.
+ *
+ * @param[in] table Eytzinger array (of 'size' slots).
+ * @param[in] size Number of slots in the array.
+ * @param[in] items Array of items the table was built over.
+ * @param[in] hash Hash of the item's key (see cfgitems_hash_key()).
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ *
+ * @return Pointer to the found item or NULL if there is no such item.
+ */
+struct cfgitems* cfgitems_eytzinger_find(const struct cfgitems_hash_slot* table, size_t size,
+    struct cfgitems* items, uint32_t hash, const char* module, const char* name);
+
+/**
+ * Looks up the item in the Eytzinger array, with its name given as a span
+ * (see cfgitems_eytzinger_find()).
+ *
+ * @param[in] table Eytzinger array (of 'size' slots).
+ * @param[in] size Number of slots in the array.
+ * @param[in] items Array of items the table was built over.
+ * @param[in] hash Hash of the item's key (see cfgitems_hash_span()).
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item (not null terminated).
+ * @param[in] name_len Length of the name.
+ *
+ * @return Pointer to the found item or NULL if there is no such item.
+ */
+struct cfgitems* cfgitems_eytzinger_find_span(const struct cfgitems_hash_slot* table, size_t size,
+    struct cfgitems* items, uint32_t hash, const char* module, const char* name, size_t name_len);
+
+#endif /* _CFGITEMS_EYTZINGER_H_ */
@@ -0,0 +1,177 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_hash.h
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_HASH_H_
+#define _CFGITEMS_HASH_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+/*
+ * Slot of the open addressing (linear probing) hash table.
+ * 'id' is the position of the item in the items array increased by one,
+ * so that zero denotes an empty slot.
+ */
+struct cfgitems_hash_slot
+{
+    uint32_t hash;
+    uint32_t id;
+};
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * Feeds the string (including its terminating null character,
+ * which separates module from name) into the FNV-1a hash state.
+ */
+static inline uint32_t cfgitems_hash_string(uint32_t h, const char* str)
+{
+    do {
+        h ^= (unsigned char)*str;
+        h *= CFGITEMS_HASH_PRIME;
+    } while (*str++ != '\0');
+
+    return h;
+}
+
+/*
+ * Feeds the span of 'len' characters (followed by the terminating null
+ * character, as if it was a string) into the FNV-1a hash state.
+ */
+static inline uint32_t cfgitems_hash_span(uint32_t h, const char* str, size_t len)
+{
+    for (const char* end = str + len; str < end; ++str) {
+        h ^= (unsigned char)*str;
+        h *= CFGITEMS_HASH_PRIME;
+    }
+
+    return h * CFGITEMS_HASH_PRIME;
+}
+
+/*
+ * Checks whether the string equals the span of 'len' characters.
+ * The span must not contain null characters.
+ */
+static inline bool cfgitems_span_equals(const char* str, const char* span, size_t len)
+{
+    return !strncmp(str, span, len) && (str[len] == '\0');
+}
+
+/*
+ * Avalanches the FNV-1a state (murmur3 finalizer), so that all bits
+ * of the resulting hash can be used to select a slot.
+ */
+static inline uint32_t cfgitems_hash_final(uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+
+    return h;
+}
+
+/*
+ * Completes the hash of the item's key given the state
+ * of the hash after its module has been fed into it.
+ */
+static inline uint32_t cfgitems_hash_name(uint32_t state, const char* name)
+{
+    return cfgitems_hash_final(cfgitems_hash_string(state, name));
+}
+
+static inline uint32_t cfgitems_hash_key(const char* module, const char* name)
+{
+    return cfgitems_hash_name(cfgitems_hash_string(CFGITEMS_HASH_OFFSET_BASIS, module), name);
+}
+
+/*
+ * Number of slots used for n items. Keeps the load factor at 0.5.
+ */
+static inline size_t cfgitems_hash_size(size_t n)
+{
+    return 2 * n;
+}
+
+/*
+ * Maps the hash onto [0, size) range without division.
+ */
+static inline size_t cfgitems_hash_slot(uint32_t hash, size_t size)
+{
+    return (size_t)(((uint64_t)hash * size) >> 32);
+}
+
+/*===========================================================================*\
+ * global (external linkage) object declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * function forward declarations (external linkage)
+\*===========================================================================*/
+/**
+ * Inserts the item into the hash table. Table must have a free slot.
+ *
+ * @param[in] table Hash table (array of 'size' slots).
+ * @param[in] size Number of slots in the table.
+ * @param[in] hash Hash of the item's key (see cfgitems_hash_key()).
+ * @param[in] id Position of the item in the items array.
+ */
+void cfgitems_hash_insert(struct cfgitems_hash_slot* table, size_t size,
+    uint32_t hash, size_t id);
+
+/**
+ * Looks up the item in the hash table.
+ *
+ * @param[in] table Hash table (array of 'size' slots).
+ * @param[in] size Number of slots in the table.
+ * @param[in] items Array of items the table was built over.
+ * @param[in] hash Hash of the item's key (see cfgitems_hash_key()).
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item.
+ *
+ * @return Pointer to the found item or NULL if there is no such item.
+ */
+struct cfgitems* cfgitems_hash_find(const struct cfgitems_hash_slot* table, size_t size,
+    struct cfgitems* items, uint32_t hash, const char* module, const char* name);
+
+/**
+ * Looks up the item in the hash table, with its name given as a span
+ * (see cfgitems_hash_find()).
+ *
+ * @param[in] table Hash table (array of 'size' slots).
+ * @param[in] size Number of slots in the table.
+ * @param[in] items Array of items the table was built over.
+ * @param[in] hash Hash of the item's key (see cfgitems_hash_span()).
+ * @param[in] module Module name the item belongs to.
+ * @param[in] name Name of the configuration item (not null terminated).
+ * @param[in] name_len Length of the name.
+ *
+ * @return Pointer to the found item or NULL if there is no such item.
+ */
+struct cfgitems* cfgitems_hash_find_span(const struct cfgitems_hash_slot* table, size_t size,
+    struct cfgitems* items, uint32_t hash, const char* module, const char* name, size_t name_len);
+
+#endif /* _CFGITEMS_HASH_H_ */
@@ -0,0 +1,87 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_image.h
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_IMAGE_H_
+#define _CFGITEMS_IMAGE_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdint.h>
+#include <string.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <cfgitems_section.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+#define CFGITEMS_IMAGE_MAGIC   0x43474643u /* 'CFGC' */
+#define CFGITEMS_IMAGE_VERSION 1u
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+/*
+ * Compiled configuration (see cfgitems-compile and cfgitems_load_compiled()),
+ * values already converted to the types of their items:
+ *
+ *   struct cfgitems_image_header header;
+ *   struct cfgitems_image_value values[n_values]; in the order of the items
+ *   char strings[strings_size]; values of string items, not null terminated
+ *
+ * The image is only valid for the registry (all the items, their keys
+ * and types) it has been compiled against, see cfgitems_image_registry().
+ */
+struct cfgitems_image_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t registry;
+    uint64_t checksum; /* digest of everything following the header */
+    uint32_t n_values;
+    uint32_t strings_size;
+};
+
+struct cfgitems_image_value
+{
+    uint32_t hash; /* of the key of the item (see cfgitems_hash_key()) */
+    uint32_t item; /* position of the item in (module, name) order */
+    uint32_t type;
+    uint32_t length; /* of the string, 0 for other types */
+    uint64_t value; /* bits of union cfgitems_any, offset within the strings for strings */
+};
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * Adds the item to the digest of the registry. Items are added
+ * in (module, name) order (see cfgitems_compare_keys()), starting
+ * with the digest equal to CFGITEMS_IMAGE_VERSION.
+ */
+static inline uint64_t cfgitems_image_registry(uint64_t registry, const char* module,
+    const char* name, uint32_t type)
+{
+    registry = cfgitems_digest_merge(registry, cfgitems_digest(module, strlen(module)));
+    registry = cfgitems_digest_merge(registry, cfgitems_digest(name, strlen(name)));
+
+    return cfgitems_digest_merge(registry, type);
+}
+
+/*===========================================================================*\
+ * global (external linkage) object declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * function forward declarations (external linkage)
+\*===========================================================================*/
+
+#endif /* _CFGITEMS_IMAGE_H_ */
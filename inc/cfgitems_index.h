@@ -0,0 +1,162 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_index.h
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_INDEX_H_
+#define _CFGITEMS_INDEX_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <cfgitems_hash.h>
+#include <cfgitems_module.h>
+#include <cfgitems_eytzinger.h>
+#include <cfgitems_bloom.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+#define CFGITEMS_INDEX_MAGIC   0x49474643u /* 'CFGI' */
+/*
+ * Items are looked up either through the open addressing hash table
+ * or (with CFGITEMS_EYTZINGER_INDEX) by searching their hashes laid out
+ * in Eytzinger order. The layout is a part of the index version, so that
+ * an index prepared for the other layout is not used.
+ */
+#if defined(CFGITEMS_EYTZINGER_INDEX)
+    #define CFGITEMS_INDEX_LAYOUT 1u
+#else
+    #define CFGITEMS_INDEX_LAYOUT 0u
+#endif
+
+#define CFGITEMS_INDEX_VERSION (3u | (CFGITEMS_INDEX_LAYOUT << 16))
+
+#define CFGITEMS_INDEX_HEADER_WORDS \
+    (sizeof(struct cfgitems_index_header) / sizeof(uint32_t))
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+/*
+ * Layout of the presorted index section (all fields are 32-bit words):
+ *
+ *   struct cfgitems_index_header header;
+ *   uint32_t order[n_items];          positions of the items in the items
+ *                                     section, sorted by (module, name)
+ *   struct cfgitems_hash_slot hash[]; cfgitems_index_table_size(n_items) slots
+ *   struct cfgitems_module modules[n_modules];
+ *   struct cfgitems_hash_slot modules_hash[]; cfgitems_hash_size(n_modules) slots
+ *   uint32_t bloom[];                 cfgitems_bloom_words(n_items) words
+ */
+struct cfgitems_index_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t n_entries; /* number of entries in the items section */
+    uint32_t n_items;   /* number of items (entries with module set) */
+    uint32_t n_modules; /* number of entries in the module directory */
+};
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * Ordering of the items: global module first, then other modules
+ * in alphabetical order, and items by name within the module.
+ */
+static inline int cfgitems_compare_keys(const char* lmodule, const char* lname,
+    const char* rmodule, const char* rname)
+{
+    int status;
+
+    status = strcmp(lmodule, rmodule);
+    if (status) {
+        if (!strcmp(lmodule, CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE)))
+            return -1;
+        else
+        if (!strcmp(rmodule, CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE)))
+            return +1;
+        else
+            return status;
+    }
+
+    status = strcmp(lname, rname);
+
+    return status;
+}
+
+/*
+ * Number of slots of the table the items are looked up in.
+ */
+static inline size_t cfgitems_index_table_size(size_t n_items)
+{
+#if defined(CFGITEMS_EYTZINGER_INDEX)
+    return cfgitems_eytzinger_size(n_items);
+#else
+    return cfgitems_hash_size(n_items);
+#endif
+}
+
+/*
+ * Builds the table the items are looked up in.
+ * 'entries' holds (hash, position + 1) pairs of the items and is used
+ * as a scratch space.
+ */
+static inline void cfgitems_index_table_build(struct cfgitems_hash_slot* table, size_t size,
+    struct cfgitems_hash_slot* entries, size_t n_items)
+{
+#if defined(CFGITEMS_EYTZINGER_INDEX)
+    (void)size;
+    cfgitems_eytzinger_build(table, entries, n_items);
+#else
+    for (size_t i = 0; i < n_items; ++i)
+        cfgitems_hash_insert(table, size, entries[i].hash, entries[i].id - 1);
+#endif
+}
+
+static inline struct cfgitems* cfgitems_index_table_find(const struct cfgitems_hash_slot* table,
+    size_t size, struct cfgitems* items, uint32_t hash, const char* module, const char* name)
+{
+#if defined(CFGITEMS_EYTZINGER_INDEX)
+    return cfgitems_eytzinger_find(table, size, items, hash, module, name);
+#else
+    return cfgitems_hash_find(table, size, items, hash, module, name);
+#endif
+}
+
+static inline struct cfgitems* cfgitems_index_table_find_span(const struct cfgitems_hash_slot* table,
+    size_t size, struct cfgitems* items, uint32_t hash, const char* module, const char* name,
+    size_t name_len)
+{
+#if defined(CFGITEMS_EYTZINGER_INDEX)
+    return cfgitems_eytzinger_find_span(table, size, items, hash, module, name, name_len);
+#else
+    return cfgitems_hash_find_span(table, size, items, hash, module, name, name_len);
+#endif
+}
+
+/*
+ * Number of 32-bit words the presorted index of n items
+ * (belonging to m modules) occupies.
+ */
+static inline size_t cfgitems_index_words(size_t n_items, size_t n_modules)
+{
+    return CFGITEMS_INDEX_HEADER_WORDS + n_items +
+        cfgitems_index_table_size(n_items) * (sizeof(struct cfgitems_hash_slot) / sizeof(uint32_t)) +
+        n_modules * (sizeof(struct cfgitems_module) / sizeof(uint32_t)) +
+        cfgitems_hash_size(n_modules) * (sizeof(struct cfgitems_hash_slot) / sizeof(uint32_t)) +
+        cfgitems_bloom_words(n_items);
+}
+
+#endif /* _CFGITEMS_INDEX_H_ */
@@ -0,0 +1,108 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_module.h
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_MODULE_H_
+#define _CFGITEMS_MODULE_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <cfgitems_hash.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+/*
+ * Entry of the module directory. Items of each module occupy
+ * a contiguous range [first, first + count) of the sorted order.
+ * Modules are hashed on their own (see cfgitems_module_hash())
+ * and 'state' allows to continue the hash of the module's items
+ * with just their names (see cfgitems_hash_name()).
+ */
+struct cfgitems_module
+{
+    uint32_t hash;
+    uint32_t state;
+    uint32_t first;
+    uint32_t count;
+};
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+static inline uint32_t cfgitems_module_state(const char* module)
+{
+    return cfgitems_hash_string(CFGITEMS_HASH_OFFSET_BASIS, module);
+}
+
+static inline uint32_t cfgitems_module_hash(uint32_t state)
+{
+    return cfgitems_hash_final(state);
+}
+
+/*
+ * Accounts the item at 'position' of the sorted order in the module directory.
+ * Items have to be added in the sorted order, 'previous' is the module
+ * of the previously added item (NULL for the very first one).
+ *
+ * @return Number of modules in the directory.
+ */
+static inline size_t cfgitems_module_add(struct cfgitems_module* modules, size_t n_modules,
+    const char* module, const char* previous, size_t position)
+{
+    if ((previous == NULL) || strcmp(previous, module)) {
+        struct cfgitems_module* m = &modules[n_modules++];
+
+        m->state = cfgitems_module_state(module);
+        m->hash = cfgitems_module_hash(m->state);
+        m->first = (uint32_t)position;
+        m->count = 0;
+    }
+
+    modules[n_modules - 1].count++;
+
+    return n_modules;
+}
+
+/*===========================================================================*\
+ * global (external linkage) object declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * function forward declarations (external linkage)
+\*===========================================================================*/
+/**
+ * Looks up the module in the module hash table.
+ *
+ * @param[in] table Hash table (array of 'size' slots) over the modules.
+ * @param[in] size Number of slots in the table.
+ * @param[in] modules Module directory the table was built over.
+ * @param[in] items Array of items.
+ * @param[in] order Positions of the items sorted by (module, name).
+ * @param[in] hash Hash of the module (see cfgitems_module_hash()).
+ * @param[in] module Module name (not null terminated).
+ * @param[in] module_len Length of the module name.
+ *
+ * @return Pointer to the found module or NULL if there is no such module.
+ */
+const struct cfgitems_module* cfgitems_module_find(const struct cfgitems_hash_slot* table,
+    size_t size, const struct cfgitems_module* modules, const struct cfgitems* items,
+    const uint32_t* order, uint32_t hash, const char* module, size_t module_len);
+
+#endif /* _CFGITEMS_MODULE_H_ */
@@ -0,0 +1,62 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_notify.h
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_NOTIFY_H_
+#define _CFGITEMS_NOTIFY_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdint.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+/* subscribes to all the items of the module (see cfgitems_subscribe()) */
+#define CFGITEMS_NOTIFY_WILDCARD "*"
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+/*
+ * Node of the (intrusive, multiple producers, single consumer) queue
+ * of the changed items. Each item has its own node, so it can be queued
+ * only once. Changes of the item made while it is still queued are
+ * coalesced into a single notification.
+ */
+struct cfgitems_notify_node
+{
+    struct cfgitems_notify_node* next;
+    uint32_t queued;
+};
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * function forward declarations (external linkage)
+\*===========================================================================*/
+/**
+ * Queues notification of the change of the item for the dispatcher thread
+ * (if anybody has subscribed at all). Never blocks. Has to be called after
+ * the value of the item has been changed.
+ *
+ * @param[in] cfgitem Changed configuration item.
+ */
+void cfgitems_notify(struct cfgitems* cfgitem);
+
+#endif /* _CFGITEMS_NOTIFY_H_ */
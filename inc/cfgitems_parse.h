@@ -0,0 +1,328 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_parse.h
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_PARSE_H_
+#define _CFGITEMS_PARSE_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+/* doubles up to this length are converted from a copy on the stack */
+#define CFGITEMS_PARSE_DOUBLE_MAX 64
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * The configuration is tokenized into spans (pointer and length) over
+ * the buffer holding it, which is never modified (see cfgitems_scan()).
+ * Spans never contain null characters. Values are converted straight
+ * from their spans, with the very same rules as cfgitems_to_xxx()
+ * functions apply to null terminated strings.
+ */
+static inline bool cfgitems_parse_is_space(char c)
+{
+    return isspace((unsigned char)c);
+}
+
+static inline bool cfgitems_span_equals_nocase(const char* str, size_t len, const char* literal)
+{
+    size_t i;
+
+    for (i = 0; (i < len) && (literal[i] != '\0'); ++i)
+        if (tolower((unsigned char)str[i]) != literal[i])
+            return false;
+
+    return (i == len) && (literal[i] == '\0');
+}
+
+static inline int cfgitems_span_to_bool(const char* str, size_t len, bool* value)
+{
+    if (cfgitems_span_equals_nocase(str, len, "1") ||
+        cfgitems_span_equals_nocase(str, len, "true") ||
+        cfgitems_span_equals_nocase(str, len, "on")) {
+        *value = true;
+        return CFGITEMS_SUCCESS;
+    }
+
+    if (cfgitems_span_equals_nocase(str, len, "0") ||
+        cfgitems_span_equals_nocase(str, len, "false") ||
+        cfgitems_span_equals_nocase(str, len, "off")) {
+        *value = false;
+        return CFGITEMS_SUCCESS;
+    }
+
+    return CFGITEMS_FAILURE;
+}
+
+/*
+ * Converts the span the way strtol() (base 0) does: optional leading
+ * white space and sign, then decimal, octal (0 prefix) or hexadecimal
+ * (0x prefix) digits, which have to reach the end of the span.
+ *
+ * @return CFGITEMS_SUCCESS with the sign and the magnitude of the number,
+ *         CFGITEMS_FAILURE when the span is not a number or the magnitude
+ *         exceeds UINT64_MAX.
+ */
+static inline int cfgitems_span_to_integer(const char* str, size_t len, bool* negative,
+    uint64_t* magnitude)
+{
+    const char* const end = str + len;
+    unsigned base = 10;
+    uint64_t u = 0;
+    const char* digits;
+
+    while ((str < end) && cfgitems_parse_is_space(*str))
+        str++;
+
+    *negative = false;
+    if ((str < end) && ((*str == '-') || (*str == '+')))
+        *negative = (*str++ == '-');
+
+    if ((end - str > 2) && (str[0] == '0') && ((str[1] | 0x20) == 'x') && isxdigit((unsigned char)str[2])) {
+        base = 16;
+        str += 2;
+    }
+    else
+    if ((str < end) && (str[0] == '0'))
+        base = 8;
+
+    for (digits = str; str < end; ++str) {
+        unsigned d;
+
+        if ((*str >= '0') && (*str <= '9'))
+            d = *str - '0';
+        else
+        if (((*str | 0x20) >= 'a') && ((*str | 0x20) <= 'f'))
+            d = (*str | 0x20) - 'a' + 10;
+        else
+            break;
+
+        if (d >= base)
+            break;
+
+        if (__builtin_mul_overflow(u, base, &u) || __builtin_add_overflow(u, d, &u))
+            return CFGITEMS_FAILURE;
+    }
+
+    if ((str == digits) || (str != end))
+        return CFGITEMS_FAILURE;
+
+    *magnitude = u;
+
+    return CFGITEMS_SUCCESS;
+}
+
+/*
+ * Converts the span to a signed number within [min, max]
+ * (cfgitems_to_s8() ... cfgitems_to_s64()).
+ */
+static inline int cfgitems_span_to_signed(const char* str, size_t len, int64_t min, int64_t max,
+    int64_t* value)
+{
+    bool negative;
+    uint64_t u;
+    int64_t i;
+
+    if (cfgitems_span_to_integer(str, len, &negative, &u) != CFGITEMS_SUCCESS)
+        return CFGITEMS_FAILURE;
+
+    if (negative) {
+        if (u > (uint64_t)INT64_MAX + 1)
+            return CFGITEMS_FAILURE;
+        i = (int64_t)(0 - u);
+    }
+    else {
+        if (u > (uint64_t)INT64_MAX)
+            return CFGITEMS_FAILURE;
+        i = (int64_t)u;
+    }
+
+    if ((i < min) || (i > max))
+        return CFGITEMS_FAILURE;
+
+    *value = i;
+
+    return CFGITEMS_SUCCESS;
+}
+
+/*
+ * Converts the span to an unsigned number not greater than max
+ * (cfgitems_to_u8() ... cfgitems_to_u32(), which reject negative numbers).
+ */
+static inline int cfgitems_span_to_unsigned(const char* str, size_t len, uint64_t max,
+    uint64_t* value)
+{
+    bool negative;
+    uint64_t u;
+
+    if (cfgitems_span_to_integer(str, len, &negative, &u) != CFGITEMS_SUCCESS)
+        return CFGITEMS_FAILURE;
+
+    if ((negative && (u != 0)) || (u > max))
+        return CFGITEMS_FAILURE;
+
+    *value = u;
+
+    return CFGITEMS_SUCCESS;
+}
+
+/*
+ * Converts the span to uint64_t. Like cfgitems_to_u64() (strtoull())
+ * it accepts negative numbers, which wrap around.
+ */
+static inline int cfgitems_span_to_u64(const char* str, size_t len, uint64_t* value)
+{
+    bool negative;
+    uint64_t u;
+
+    if (cfgitems_span_to_integer(str, len, &negative, &u) != CFGITEMS_SUCCESS)
+        return CFGITEMS_FAILURE;
+
+    *value = negative ? 0 - u : u;
+
+    return CFGITEMS_SUCCESS;
+}
+
+/*
+ * Converts the span to double. strtod() needs a null terminated string,
+ * so the span is copied (to the stack, unless it is unusually long).
+ */
+static inline int cfgitems_span_to_double(const char* str, size_t len, double* value)
+{
+    char buf[CFGITEMS_PARSE_DOUBLE_MAX];
+    char* copy = buf;
+    char* endptr;
+    int retval = CFGITEMS_FAILURE;
+    double d;
+
+    if (len == 0)
+        return CFGITEMS_FAILURE;
+
+    if ((len >= sizeof(buf)) && ((copy = malloc(len + 1)) == NULL))
+        return CFGITEMS_FAILURE;
+
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+
+    do {
+        errno = 0, d = strtod(copy, &endptr);
+
+        if (*endptr != '\0')
+            break; /* string is invalid (has unparsed characters) */
+
+        if ((errno == ERANGE) && ((d == -HUGE_VAL) || (d == HUGE_VAL)))
+            break; /* number in string exceeds 'double' range */
+
+        if ((d == 0) && (errno != 0))
+            break; /* no valid conversion was performed */
+
+        *value = d;
+
+        retval = CFGITEMS_SUCCESS;
+    } while (0);
+
+    if (copy != buf)
+        free(copy);
+
+    return retval;
+}
+
+/*
+ * Converts the value (span of 'len' characters) to the type of the item.
+ */
+static inline int cfgitems_span_to_any(enum cfgitems_type type, const char* value, size_t len,
+    union cfgitems_any* any)
+{
+    int64_t s;
+    uint64_t u;
+    int status;
+
+    switch (type) {
+        case CFGITEMS_TYPE_BOOL:
+            return cfgitems_span_to_bool(value, len, &any->_BOOL_);
+
+        case CFGITEMS_TYPE_DOUBLE:
+            return cfgitems_span_to_double(value, len, &any->_DOUBLE_);
+
+        case CFGITEMS_TYPE_S8:
+            status = cfgitems_span_to_signed(value, len, INT8_MIN, INT8_MAX, &s);
+            if (status == CFGITEMS_SUCCESS)
+                any->_S8_ = (int8_t)s;
+            return status;
+
+        case CFGITEMS_TYPE_U8:
+            status = cfgitems_span_to_unsigned(value, len, UINT8_MAX, &u);
+            if (status == CFGITEMS_SUCCESS)
+                any->_U8_ = (uint8_t)u;
+            return status;
+
+        case CFGITEMS_TYPE_S16:
+            status = cfgitems_span_to_signed(value, len, INT16_MIN, INT16_MAX, &s);
+            if (status == CFGITEMS_SUCCESS)
+                any->_S16_ = (int16_t)s;
+            return status;
+
+        case CFGITEMS_TYPE_U16:
+            status = cfgitems_span_to_unsigned(value, len, UINT16_MAX, &u);
+            if (status == CFGITEMS_SUCCESS)
+                any->_U16_ = (uint16_t)u;
+            return status;
+
+        case CFGITEMS_TYPE_S32:
+            status = cfgitems_span_to_signed(value, len, INT32_MIN, INT32_MAX, &s);
+            if (status == CFGITEMS_SUCCESS)
+                any->_S32_ = (int32_t)s;
+            return status;
+
+        case CFGITEMS_TYPE_U32:
+            status = cfgitems_span_to_unsigned(value, len, UINT32_MAX, &u);
+            if (status == CFGITEMS_SUCCESS)
+                any->_U32_ = (uint32_t)u;
+            return status;
+
+        case CFGITEMS_TYPE_S64:
+            return cfgitems_span_to_signed(value, len, INT64_MIN, INT64_MAX, &any->_S64_);
+
+        case CFGITEMS_TYPE_U64:
+            return cfgitems_span_to_u64(value, len, &any->_U64_);
+
+        default:
+            return CFGITEMS_FAILURE;
+    }
+}
+
+/*===========================================================================*\
+ * global (external linkage) object declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * function forward declarations (external linkage)
+\*===========================================================================*/
+
+#endif /* _CFGITEMS_PARSE_H_ */
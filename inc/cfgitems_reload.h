@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_reload.h
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_RELOAD_H_
+#define _CFGITEMS_RELOAD_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * function forward declarations (external linkage)
+\*===========================================================================*/
+/**
+ * Parses configuration file the way cfgitems_parse() does, but writes
+ * (and notifies) only the items whose values differ from the parsed ones.
+ *
+ * @param[in] filename Path to the file containing configuration items
+ *                     in .ini file format.
+ *
+ * @return CFGITEMS_SUCCESS on success, CFGITEMS_FAILURE value otherwise.
+ */
+int cfgitems_parse_changes(const char* filename);
+
+#endif /* _CFGITEMS_RELOAD_H_ */
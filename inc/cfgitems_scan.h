@@ -0,0 +1,115 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_scan.h
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_SCAN_H_
+#define _CFGITEMS_SCAN_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+/*
+ * Position of the tokenizer within the configuration (the buffer
+ * holding it is only read).
+ */
+struct cfgitems_scanner
+{
+    const char* next; /* beginning of the next line */
+    const char* end;
+};
+
+enum cfgitems_token_type
+{
+    CFGITEMS_TOKEN_SECTION, /* '[name]' line */
+    CFGITEMS_TOKEN_ITEM, /* 'name = value' line */
+};
+
+/*
+ * Token of the configuration, one per line which is neither empty
+ * nor a comment. Names and values are spans over the scanned buffer,
+ * the value is delimited by "\t =" (just like the name) and is empty
+ * when the line has none. Sections with no closing ']' produce no token.
+ */
+struct cfgitems_token
+{
+    enum cfgitems_token_type type;
+    const char* name;
+    size_t name_len;
+    const char* value;
+    size_t value_len;
+};
+
+/*
+ * Instruction sets the tokenizer has been implemented with.
+ */
+enum cfgitems_scan_isa
+{
+    CFGITEMS_SCAN_SCALAR,
+    CFGITEMS_SCAN_SSE2,
+    CFGITEMS_SCAN_AVX2,
+};
+
+/*
+ * Tokenizes the configuration (see cfgitems_scan()).
+ */
+typedef size_t (*cfgitems_scan_t)(struct cfgitems_scanner* scanner,
+    struct cfgitems_token* tokens, size_t n);
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+static inline void cfgitems_scanner_init(struct cfgitems_scanner* scanner,
+    const char* buf, size_t size)
+{
+    scanner->next = buf;
+    scanner->end = buf + size;
+}
+
+/*===========================================================================*\
+ * global (external linkage) object declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * function forward declarations (external linkage)
+\*===========================================================================*/
+/**
+ * Tokenizes next lines of the configuration with the fastest tokenizer
+ * the processor supports (chosen at the first call).
+ *
+ * @param[in,out] scanner Position within the configuration.
+ * @param[out] tokens Array the tokens are stored in.
+ * @param[in] n Size of the array.
+ *
+ * @return Number of the stored tokens, 0 once the whole configuration
+ *         has been tokenized.
+ */
+size_t cfgitems_scan(struct cfgitems_scanner* scanner, struct cfgitems_token* tokens, size_t n);
+
+/**
+ * Gets the tokenizer implemented with the given instruction set.
+ * All of them produce the very same tokens.
+ *
+ * @param[in] isa Instruction set.
+ *
+ * @return The tokenizer or NULL if the processor (or the architecture
+ *         the library has been built for) does not support the instruction set.
+ */
+cfgitems_scan_t cfgitems_scan_get(enum cfgitems_scan_isa isa);
+
+#endif /* _CFGITEMS_SCAN_H_ */
@@ -0,0 +1,168 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_section.h
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_SECTION_H_
+#define _CFGITEMS_SECTION_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+#define CFGITEMS_DIGEST_PRIME_1 0x9E3779B185EBCA87ULL
+#define CFGITEMS_DIGEST_PRIME_2 0xC2B2AE3D27D4EB4FULL
+#define CFGITEMS_DIGEST_PRIME_3 0x165667B19E3779F9ULL
+#define CFGITEMS_DIGEST_PRIME_4 0x85EBCA77C2B2AE63ULL
+#define CFGITEMS_DIGEST_PRIME_5 0x27D4EB2F165667C5ULL
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+/*
+ * Sections of each module are tracked by the parser. 'writes' counts
+ * the writes of the items of the module (by anybody), 'key' identifies
+ * the sections (all of them, in their order) applied last together
+ * with the number of the writes right after them (see cfgitems_section_key()).
+ * While nothing else has written the items, the sections would set them
+ * to the values they have already, so applying them again can be skipped.
+ */
+struct cfgitems_section
+{
+    uint32_t writes;
+    uint64_t key; /* 0 when there is no such section */
+};
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+static inline uint64_t cfgitems_digest_rotl(uint64_t x, unsigned r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t cfgitems_digest_read64(const char* p)
+{
+    uint64_t v;
+
+    memcpy(&v, p, sizeof(v));
+
+    return v;
+}
+
+static inline uint32_t cfgitems_digest_read32(const char* p)
+{
+    uint32_t v;
+
+    memcpy(&v, p, sizeof(v));
+
+    return v;
+}
+
+static inline uint64_t cfgitems_digest_round(uint64_t acc, uint64_t input)
+{
+    acc += input * CFGITEMS_DIGEST_PRIME_2;
+    acc = cfgitems_digest_rotl(acc, 31);
+
+    return acc * CFGITEMS_DIGEST_PRIME_1;
+}
+
+static inline uint64_t cfgitems_digest_merge(uint64_t acc, uint64_t v)
+{
+    acc ^= cfgitems_digest_round(0, v);
+
+    return acc * CFGITEMS_DIGEST_PRIME_1 + CFGITEMS_DIGEST_PRIME_4;
+}
+
+/*
+ * Digest of the bytes of the section (XXH64 with seed 0), 32 bytes
+ * at a time in four independent lanes.
+ */
+static inline uint64_t cfgitems_digest(const char* p, size_t len)
+{
+    const char* const end = p + len;
+    uint64_t h;
+
+    if (len >= 32) {
+        uint64_t v1 = CFGITEMS_DIGEST_PRIME_1 + CFGITEMS_DIGEST_PRIME_2;
+        uint64_t v2 = CFGITEMS_DIGEST_PRIME_2;
+        uint64_t v3 = 0;
+        uint64_t v4 = 0 - CFGITEMS_DIGEST_PRIME_1;
+
+        do {
+            v1 = cfgitems_digest_round(v1, cfgitems_digest_read64(p));
+            v2 = cfgitems_digest_round(v2, cfgitems_digest_read64(p + 8));
+            v3 = cfgitems_digest_round(v3, cfgitems_digest_read64(p + 16));
+            v4 = cfgitems_digest_round(v4, cfgitems_digest_read64(p + 24));
+            p += 32;
+        } while (end - p >= 32);
+
+        h = cfgitems_digest_rotl(v1, 1) + cfgitems_digest_rotl(v2, 7) +
+            cfgitems_digest_rotl(v3, 12) + cfgitems_digest_rotl(v4, 18);
+        h = cfgitems_digest_merge(h, v1);
+        h = cfgitems_digest_merge(h, v2);
+        h = cfgitems_digest_merge(h, v3);
+        h = cfgitems_digest_merge(h, v4);
+    }
+    else
+        h = CFGITEMS_DIGEST_PRIME_5;
+
+    h += len;
+
+    for (; end - p >= 8; p += 8) {
+        h ^= cfgitems_digest_round(0, cfgitems_digest_read64(p));
+        h = cfgitems_digest_rotl(h, 27) * CFGITEMS_DIGEST_PRIME_1 + CFGITEMS_DIGEST_PRIME_4;
+    }
+
+    if (end - p >= 4) {
+        h ^= cfgitems_digest_read32(p) * CFGITEMS_DIGEST_PRIME_1;
+        h = cfgitems_digest_rotl(h, 23) * CFGITEMS_DIGEST_PRIME_2 + CFGITEMS_DIGEST_PRIME_3;
+        p += 4;
+    }
+
+    for (; p < end; ++p) {
+        h ^= (unsigned char)*p * CFGITEMS_DIGEST_PRIME_5;
+        h = cfgitems_digest_rotl(h, 11) * CFGITEMS_DIGEST_PRIME_1;
+    }
+
+    h ^= h >> 33;
+    h *= CFGITEMS_DIGEST_PRIME_2;
+    h ^= h >> 29;
+    h *= CFGITEMS_DIGEST_PRIME_3;
+    h ^= h >> 32;
+
+    return h;
+}
+
+/*
+ * Key of the sections with the digest, applied when the items
+ * of their module have been written 'writes' times. Never 0.
+ */
+static inline uint64_t cfgitems_section_key(uint64_t digest, uint32_t writes)
+{
+    uint64_t key = digest ^ cfgitems_digest_round(0, writes);
+
+    return key ? key : 1;
+}
+
+/*===========================================================================*\
+ * global (external linkage) object declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * function forward declarations (external linkage)
+\*===========================================================================*/
+
+#endif /* _CFGITEMS_SECTION_H_ */
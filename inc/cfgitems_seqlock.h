@@ -0,0 +1,129 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_seqlock.h
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_SEQLOCK_H_
+#define _CFGITEMS_SEQLOCK_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+#if defined(__x86_64__) || defined(__i386__)
+    #define CFGITEMS_CPU_RELAX() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+    #define CFGITEMS_CPU_RELAX() __asm__ __volatile__("yield")
+#else
+    #define CFGITEMS_CPU_RELAX() do {} while (0)
+#endif
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object declarations
+\*===========================================================================*/
+/* set once by cfgitems_freeze(), items never change afterwards */
+extern bool cfgitems_frozen;
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * With CFGITEMS_THREAD_SAFE each item is guarded by its own sequence counter
+ * (seqlock). The counter is odd while the item is being written. Writers
+ * of the same item exclude each other by making it odd with compare and swap,
+ * writers of different items never contend. Readers never write anything,
+ * they just read again when the counter was odd or has changed meanwhile.
+ *
+ *   do {
+ *       seq = cfgitems_read_begin(cfgitem);
+ *       ... read the value ...
+ *   } while (cfgitems_read_retry(cfgitem, seq));
+ *
+ * Without CFGITEMS_THREAD_SAFE all of these compile to nothing.
+ * Once the items are frozen (see cfgitems_freeze()) readers skip
+ * the counter altogether.
+ */
+static inline uint32_t cfgitems_read_begin(const struct cfgitems* cfgitem)
+{
+#if defined(CFGITEMS_THREAD_SAFE)
+    uint32_t seq;
+
+    /* there are no writers any more */
+    if (__atomic_load_n(&cfgitems_frozen, __ATOMIC_RELAXED))
+        return 0;
+
+    while ((seq = __atomic_load_n(&cfgitem->seq, __ATOMIC_ACQUIRE)) & 1)
+        CFGITEMS_CPU_RELAX();
+
+    return seq;
+#else
+    (void)cfgitem;
+    return 0;
+#endif
+}
+
+static inline bool cfgitems_read_retry(const struct cfgitems* cfgitem, uint32_t seq)
+{
+#if defined(CFGITEMS_THREAD_SAFE)
+    if (__atomic_load_n(&cfgitems_frozen, __ATOMIC_RELAXED))
+        return false;
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&cfgitem->seq, __ATOMIC_RELAXED) != seq;
+#else
+    (void)cfgitem;
+    (void)seq;
+    return false;
+#endif
+}
+
+static inline void cfgitems_write_begin(struct cfgitems* cfgitem)
+{
+#if defined(CFGITEMS_THREAD_SAFE)
+    uint32_t seq = __atomic_load_n(&cfgitem->seq, __ATOMIC_RELAXED);
+
+    for (;;) {
+        if (!(seq & 1) && __atomic_compare_exchange_n(&cfgitem->seq, &seq, seq + 1,
+                true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            break;
+        CFGITEMS_CPU_RELAX();
+        seq = __atomic_load_n(&cfgitem->seq, __ATOMIC_RELAXED);
+    }
+
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+#else
+    (void)cfgitem;
+#endif
+}
+
+static inline void cfgitems_write_end(struct cfgitems* cfgitem)
+{
+#if defined(CFGITEMS_THREAD_SAFE)
+    __atomic_store_n(&cfgitem->seq, __atomic_load_n(&cfgitem->seq, __ATOMIC_RELAXED) + 1,
+        __ATOMIC_RELEASE);
+#else
+    (void)cfgitem;
+#endif
+}
+
+/*===========================================================================*\
+ * function forward declarations (external linkage)
+\*===========================================================================*/
+
+#endif /* _CFGITEMS_SEQLOCK_H_ */
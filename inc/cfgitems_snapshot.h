@@ -0,0 +1,84 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_snapshot.h
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_SNAPSHOT_H_
+#define _CFGITEMS_SNAPSHOT_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+/* number of snapshots a single thread can hold at the same time */
+#define CFGITEMS_SNAPSHOT_SLOTS 4
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+/*
+ * Immutable copy of the values of all the items. values[] is indexed
+ * by the position of the item in the items section, strings[] holds
+ * copies of the strings set by updates (string literals, i.e. default
+ * values, are not copied).
+ */
+struct cfgitems_snapshot
+{
+    uint64_t version;
+    uint64_t stamp; /* cfgitems_snapshot_stamp the values have been copied at */
+    struct cfgitems_snapshot* retired; /* next one on the list of retired snapshots */
+    size_t n_entries;
+    char* strings;
+    union cfgitems_any values[];
+};
+
+/*===========================================================================*\
+ * global (external linkage) object declarations
+\*===========================================================================*/
+/* counts the changes of the values, see cfgitems_snapshot_touch() */
+extern uint64_t cfgitems_snapshot_stamp;
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * Marks the current snapshot as out of date. Has to be called after
+ * the value of an item has been written (after cfgitems_write_end()).
+ * The new snapshot is taken by the next cfgitems_snapshot_acquire(),
+ * writers neither copy the values nor take any lock.
+ */
+static inline void cfgitems_snapshot_touch(void)
+{
+    __atomic_add_fetch(&cfgitems_snapshot_stamp, 1, __ATOMIC_RELEASE);
+}
+
+/*===========================================================================*\
+ * function forward declarations (external linkage)
+\*===========================================================================*/
+/**
+ * Starts an update of many items at once. No snapshot is taken until
+ * cfgitems_snapshot_end_update() is called, thus none of them can capture
+ * the values changed only partially.
+ */
+void cfgitems_snapshot_begin_update(void);
+
+/**
+ * Ends the update started by cfgitems_snapshot_begin_update().
+ * The next cfgitems_snapshot_acquire() takes a single snapshot
+ * with all the changes.
+ */
+void cfgitems_snapshot_end_update(void);
+
+#endif /* _CFGITEMS_SNAPSHOT_H_ */
@@ -0,0 +1,117 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_string.h
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_STRING_H_
+#define _CFGITEMS_STRING_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+/*
+ * Value of 'string' item. Never changes once it has been published,
+ * an update of the item publishes a new one and retires the old one.
+ */
+struct cfgitems_string
+{
+    struct cfgitems_string* retired; /* next one on the list of retired strings */
+    uint64_t epoch; /* in which the string has been retired */
+    char str[];
+};
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * Copies 'len' characters of the string (which does not need to be
+ * null terminated), so that they can be published as the value of the item.
+ *
+ * @return Copy of the string or NULL when the string is too long
+ *         (see CFGITEMS_STRING_MAX) or memory could not be allocated.
+ */
+static inline struct cfgitems_string* cfgitems_string_create_n(const char* str, size_t len)
+{
+    struct cfgitems_string* string;
+
+    if (len >= CFGITEMS_STRING_MAX)
+        return NULL;
+
+    string = malloc(sizeof(struct cfgitems_string) + len + 1);
+    if (string == NULL)
+        return NULL;
+
+    string->retired = NULL;
+    string->epoch = 0;
+    memcpy(string->str, str, len);
+    string->str[len] = '\0';
+
+    return string;
+}
+
+/*
+ * Copies the string, so that it can be published as the value of the item.
+ *
+ * @return Copy of the string or NULL when the string is too long
+ *         (see CFGITEMS_STRING_MAX) or memory could not be allocated.
+ */
+static inline struct cfgitems_string* cfgitems_string_create(const char* str)
+{
+    return cfgitems_string_create_n(str, strlen(str));
+}
+
+/*
+ * Publishes the string as the value of the item. Has to be called
+ * by the writer of the item, between cfgitems_write_begin()
+ * and cfgitems_write_end().
+ *
+ * @return The replaced string (to be retired by the caller once the item
+ *         has been written) or NULL when the item had its default value.
+ */
+static inline struct cfgitems_string* cfgitems_string_replace(struct cfgitems* cfgitem,
+    struct cfgitems_string* string)
+{
+    struct cfgitems_string* old = cfgitem->string;
+
+    cfgitem->string = string;
+    __atomic_store_n(&cfgitem->value->_STRING_, string->str, __ATOMIC_RELEASE);
+
+    return old;
+}
+
+/*===========================================================================*\
+ * global (external linkage) object declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * function forward declarations (external linkage)
+\*===========================================================================*/
+/**
+ * Retires the string replaced by cfgitems_string_replace(). It is never
+ * freed here, but by cfgitems_reclaim() once all the read side critical
+ * sections (see cfgitems_read_lock()) which could have obtained it
+ * have ended.
+ *
+ * @param[in] string Replaced string (NULL is ignored).
+ */
+void cfgitems_string_retire(struct cfgitems_string* string);
+
+#endif /* _CFGITEMS_STRING_H_ */
@@ -0,0 +1,161 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_txn.h
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_TXN_H_
+#define _CFGITEMS_TXN_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+/*
+ * Staged update of a single item. Keys (and string values) are copied
+ * into the strings of the transaction. They are kept as offsets there
+ * while the transaction grows (as the strings may be reallocated)
+ * and turned into pointers when it is committed. The item is resolved
+ * only then as well.
+ */
+struct cfgitems_txn_entry
+{
+    size_t module_offset;
+    size_t name_offset;
+    size_t string_offset; /* of the value of 'string' item */
+    const char* module;
+    const char* name;
+    enum cfgitems_type type;
+    uint32_t seqno; /* order in which the updates were staged */
+    union cfgitems_any value;
+    struct cfgitems* cfgitem;
+    struct cfgitems_string* string; /* new value of 'string' item, once applied the replaced one */
+};
+
+struct cfgitems_txn
+{
+    struct cfgitems_txn_entry* entries;
+    size_t n_entries;
+    size_t entries_capacity;
+    char* strings;
+    size_t n_strings;
+    size_t strings_capacity;
+    bool failed; /* some update could not be staged, commit will reject the whole batch */
+};
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * Copies the string into the strings of the transaction.
+ *
+ * @return Offset of the copy or SIZE_MAX when the transaction could not grow.
+ */
+static inline size_t cfgitems_txn_strdup(struct cfgitems_txn* txn, const char* str)
+{
+    size_t len = strlen(str) + 1;
+    size_t offset = txn->n_strings;
+
+    if (txn->n_strings + len > txn->strings_capacity) {
+        size_t capacity = txn->strings_capacity ? txn->strings_capacity : 256;
+        char* strings;
+
+        while (capacity < txn->n_strings + len)
+            capacity *= 2;
+
+        strings = realloc(txn->strings, capacity);
+        if (strings == NULL)
+            return SIZE_MAX;
+
+        txn->strings = strings;
+        txn->strings_capacity = capacity;
+    }
+
+    memcpy(txn->strings + offset, str, len);
+    txn->n_strings += len;
+
+    return offset;
+}
+
+/*
+ * Stages the update of the item. On failure the transaction is marked
+ * as failed, so that it cannot be committed partially.
+ *
+ * @return Pointer to the staged entry (for the caller to fill its value)
+ *         or NULL on failure.
+ */
+static inline struct cfgitems_txn_entry* cfgitems_txn_add(struct cfgitems_txn* txn,
+    const char* module, const char* name, enum cfgitems_type type)
+{
+    struct cfgitems_txn_entry* e;
+
+    if (txn == NULL)
+        return NULL;
+
+    if (name == NULL) {
+        txn->failed = true;
+        return NULL;
+    }
+
+    if (module == NULL)
+        module = CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE);
+
+    if (txn->n_entries == txn->entries_capacity) {
+        size_t capacity = txn->entries_capacity ? 2 * txn->entries_capacity : 16;
+        struct cfgitems_txn_entry* entries;
+
+        entries = realloc(txn->entries, capacity * sizeof(struct cfgitems_txn_entry));
+        if (entries == NULL) {
+            txn->failed = true;
+            return NULL;
+        }
+
+        txn->entries = entries;
+        txn->entries_capacity = capacity;
+    }
+
+    e = &txn->entries[txn->n_entries];
+    e->module_offset = cfgitems_txn_strdup(txn, module);
+    e->name_offset = cfgitems_txn_strdup(txn, name);
+    if ((e->module_offset == SIZE_MAX) || (e->name_offset == SIZE_MAX)) {
+        txn->failed = true;
+        return NULL;
+    }
+
+    e->string_offset = SIZE_MAX;
+    memset(&e->value, 0, sizeof(e->value));
+    e->type = type;
+    e->seqno = (uint32_t)txn->n_entries++;
+    e->cfgitem = NULL;
+    e->string = NULL;
+
+    return e;
+}
+
+/*===========================================================================*\
+ * global (external linkage) object declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * function forward declarations (external linkage)
+\*===========================================================================*/
+
+#endif /* _CFGITEMS_TXN_H_ */
@@ -17,32 +17,121 @@
 #include <limits.h>
 #include <math.h>
 #include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 /*===========================================================================*\
  * project header files
 \*===========================================================================*/
 #include <cfgitems.h>
+#include <cfgitems_hash.h>
+#include <cfgitems_index.h>
+#include <cfgitems_module.h>
+#include <cfgitems_bloom.h>
+#include <cfgitems_cache.h>
+#include <cfgitems_seqlock.h>
+#include <cfgitems_snapshot.h>
+#include <cfgitems_txn.h>
+#include <cfgitems_notify.h>
+#include <cfgitems_bind.h>
+#include <cfgitems_string.h>
+#include <cfgitems_parse.h>
+#include <cfgitems_scan.h>
+#include <cfgitems_reload.h>
+#include <cfgitems_section.h>
+#include <cfgitems_image.h>
 
 /*===========================================================================*\
  * preprocessor #define constants and macros
 \*===========================================================================*/
+/* lines tokenized at once by the parser */
+#define CFGITEMS_PARSE_TOKENS 64
+
+/* initial size of the buffer of cfgitems_parse_fd(), it grows for longer lines */
+#define CFGITEMS_PARSE_CHUNK (64 * 1024)
 
 /*===========================================================================*\
  * local type definitions
 \*===========================================================================*/
+/*
+ * State of the parser carried from one part of the configuration
+ * to the next one (see cfgitems_parse_fd()).
+ */
+struct cfgitems_parser
+{
+    const struct cfgitems_module* m; /* module of the current section */
+    bool changes_only; /* items which already have the parsed values are not written */
+    uint32_t writes; /* items written by the parser within the current section */
+};
+
+/*
+ * Section of the configuration being parsed (see cfgitems_parse_configuration()).
+ */
+struct cfgitems_parse_section
+{
+    const struct cfgitems_module* m;
+    const char* begin; /* of the '[name]' line, of the configuration for the global one */
+    const char* lines; /* following the '[name]' line */
+    const char* end;
+};
+
+/*
+ * All the sections of one module found in the configuration being parsed.
+ */
+struct cfgitems_parse_module
+{
+    uint32_t sections;
+    uint32_t writes; /* of the items of the module, as of the sections */
+    uint64_t digest; /* of all the sections, in their order */
+    bool apply;
+};
 
 /*===========================================================================*\
  * global (external linkage) object definitions
 \*===========================================================================*/
+bool cfgitems_frozen = false;
 
 /*===========================================================================*\
  * local (internal linkage) function declarations
 \*===========================================================================*/
 static int cfgitems_compare(const struct cfgitems* l, const struct cfgitems* r);
-static void cfgitems_add(size_t n_options, struct cfgitems* it);
+static int cfgitems_compare_indirect(const void* l, const void* r);
+static int cfgitems_check_duplicates(void);
+static int cfgitems_build_modules(void);
+static int cfgitems_build_bloom(void);
+static void cfgitems_build_sections(size_t n_entries);
+static int cfgitems_use_presorted_index(size_t n_entries);
+static int cfgitems_build_index(size_t n_entries);
+static void cfgitems_release(void);
 static struct cfgitems* cfgitems_find(const char* module, const char* name);
-static int cfgitems_parse_configuration_line(const char* module, char* line);
-static int cfgitems_parse_configuration_file(const char* filename);
+static struct cfgitems* cfgitems_find_hashed(const char* module, const char* name, uint32_t hash);
+static const struct cfgitems_module* cfgitems_find_module(const char* module);
+static const struct cfgitems_module* cfgitems_find_module_span(const char* module, size_t len);
+static struct cfgitems* cfgitems_find_in_module(const struct cfgitems_module* m, const char* name,
+    size_t len);
+static bool cfgitems_parse_is_current(struct cfgitems* cfgitem, const char* value, size_t len,
+    const union cfgitems_any* any);
+static int cfgitems_parse_configuration_line(struct cfgitems_parser* parser,
+    const struct cfgitems_token* token);
+static void cfgitems_parse_lines(struct cfgitems_parser* parser, const char* buf, size_t size);
+static const char* cfgitems_parse_next_section(const char* lines, const char* end,
+    struct cfgitems_token* token, const char** next_lines);
+static size_t cfgitems_parse_sections(struct cfgitems_parser* parser, const char* buf,
+    size_t size, struct cfgitems_parse_section** sections);
+static void cfgitems_parse_configuration(struct cfgitems_parser* parser, const char* buf,
+    size_t size);
+static int cfgitems_parse_stream(struct cfgitems_parser* parser, int fd);
+static int cfgitems_parse_configuration_file(const char* filename, bool changes_only);
+static uint64_t cfgitems_registry_digest(void);
+static int cfgitems_image_check(const char* filename, const struct cfgitems_image_header* header,
+    size_t size);
+static int cfgitems_image_apply(const struct cfgitems_image_header* header);
+static int cfgitems_protect(const void* start, const void* end);
+static int cfgitems_txn_compare(const void* l, const void* r);
+static int cfgitems_txn_resolve(struct cfgitems_txn* txn);
+static int cfgitems_txn_apply(struct cfgitems_txn* txn);
 
 /*===========================================================================*\
  * local (internal linkage) object definitions
@@ -52,22 +141,112 @@ static const struct cfgitems cfgitems_0
     __attribute__((__used__))
     __attribute__((aligned(CFGITEMS_ALIGN))) = {0};
 
-static struct cfgitems** cfgitems = NULL;
+static uint32_t cfgitems_index_0[CFGITEMS_INDEX_WORDS]
+    __attribute__((__section__(CFGITEMS_INDEX_SECTION_NAME)))
+    __attribute__((__used__))
+    __attribute__((aligned(sizeof(uint32_t))));
+
+static union cfgitems_any cfgitems_value_0
+    __attribute__((__section__(CFGITEMS_VALUES_SECTION_NAME)))
+    __attribute__((__used__))
+    __attribute__((aligned(sizeof(union cfgitems_any))));
+
+/* positions (in the items section) of the items sorted by (module, name) */
+static const uint32_t* cfgitems_order = NULL;
 static size_t n_cfgitems = 0;
 
+static const struct cfgitems_hash_slot* cfgitems_hash = NULL;
+static size_t n_cfgitems_hash = 0;
+
+/* modules with their ranges in cfgitems_order */
+static const struct cfgitems_module* cfgitems_modules = NULL;
+static size_t n_cfgitems_modules = 0;
+
+static const struct cfgitems_hash_slot* cfgitems_modules_hash = NULL;
+static size_t n_cfgitems_modules_hash = 0;
+
+/* Bloom filter over the hashes of the items' keys */
+static const uint32_t* cfgitems_bloom = NULL;
+static size_t n_cfgitems_bloom = 0;
+
+/* look ups rejected by the Bloom filter (see cfgitems_filtered_misses()) */
+static uint64_t cfgitems_bloom_rejections = 0;
+
+/* changes each time the index is (re)built, invalidating the look up caches */
+static uint32_t cfgitems_generation = 0;
+
+static __thread struct cfgitems_cache cfgitems_cache;
+
+/* true when the index comes from the items section prepared by cfgitems-presort */
+static bool cfgitems_presorted = false;
+
+/* sections of each module (see cfgitems_parse_configuration()), NULL if they could not be allocated */
+static struct cfgitems_section* cfgitems_sections = NULL;
+
+/* index of the module of each entry of the items section */
+static uint32_t* cfgitems_item_sections = NULL;
+
+/* sections applied and skipped by the parser (see cfgitems_get_section_stats()) */
+static uint64_t cfgitems_sections_applied = 0;
+static uint64_t cfgitems_sections_skipped = 0;
+
+/* digest of the items compiled configurations have to match (see cfgitems_registry_digest()) */
+static uint64_t cfgitems_registry = 0;
+
 /*===========================================================================*\
  * static inline (internal linkage) function definitions
 \*===========================================================================*/
-static inline int cfgitems_strlcpy(char *dest, const char *src, size_t n)
+static inline struct cfgitems* cfgitems_at(size_t i)
 {
-    if (n != 0) {
-        n--;
-        for (size_t i = 0; (i < n) && (*src != '\0'); ++i)
-            *dest++ = *src++;
-        *dest = '\0';
-    }
+    return &CFGITEMS_SECTION_START + cfgitems_order[i];
+}
+
+/*
+ * @return true when the item with the hash is certainly not there.
+ */
+static inline bool cfgitems_filtered_out(uint32_t hash)
+{
+    if (cfgitems_bloom_test(cfgitems_bloom, n_cfgitems_bloom, hash))
+        return false;
+
+    __atomic_fetch_add(&cfgitems_bloom_rejections, 1, __ATOMIC_RELAXED);
+
+    return true;
+}
 
-    return *src == '\0' ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+/*
+ * Last newline character of the buffer (NULL if there is none).
+ */
+static inline const char* cfgitems_parse_last_eol(const char* buf, size_t size)
+{
+    for (const char* c = buf + size; c > buf; )
+        if (*--c == '\n')
+            return c;
+
+    return NULL;
+}
+
+/*
+ * Parsing begins in the section of the global module.
+ */
+static inline void cfgitems_parser_init(struct cfgitems_parser* parser, bool changes_only)
+{
+    parser->m = cfgitems_find_module(CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE));
+    parser->changes_only = changes_only;
+    parser->writes = 0;
+}
+
+/*
+ * Accounts the write of the item for the sections of its module.
+ * Has to be called by the writer of the item, for each write.
+ */
+static inline void cfgitems_section_touch(const struct cfgitems* cfgitem)
+{
+    struct cfgitems_section* sections = __atomic_load_n(&cfgitems_sections, __ATOMIC_ACQUIRE);
+
+    if (sections != NULL)
+        __atomic_add_fetch(&sections[cfgitems_item_sections[cfgitem - &CFGITEMS_SECTION_START]].writes,
+            1, __ATOMIC_ACQ_REL);
 }
 
 static inline int cfgitems_strcasecmp(char const* str1, char const* str2)
@@ -88,52 +267,249 @@ int cfgitems_init(const char* filename)
     struct cfgitems* const cfgitems_start_addr = &CFGITEMS_SECTION_START;
     struct cfgitems* const cfgitems_end_addr = &CFGITEMS_SECTION_END;
     ptrdiff_t distance = cfgitems_end_addr - cfgitems_start_addr;
-    size_t n = 0;
 
-    if (cfgitems != NULL)
+    if (cfgitems_order != NULL)
+        return CFGITEMS_FAILURE;
+
+    if (distance < 1)
         return CFGITEMS_FAILURE;
 
-    if (--distance < 0)
+    if (cfgitems_use_presorted_index(distance) != CFGITEMS_SUCCESS)
+        if (cfgitems_build_index(distance) != CFGITEMS_SUCCESS)
+            return CFGITEMS_FAILURE;
+
+    cfgitems_build_sections(distance);
+
+    return filename ? cfgitems_parse_configuration_file(filename, false) : CFGITEMS_SUCCESS;
+}
+
+int cfgitems_parse(const char* filename)
+{
+    if (cfgitems_frozen)
         return CFGITEMS_FAILURE;
 
-    cfgitems = calloc(distance, sizeof(struct cfgitems*));
-    if (cfgitems == NULL)
+    return filename ? cfgitems_parse_configuration_file(filename, false) : CFGITEMS_SUCCESS;
+}
+
+int cfgitems_parse_buffer(const char* buf, size_t size)
+{
+    struct cfgitems_parser parser;
+
+    if (cfgitems_frozen)
         return CFGITEMS_FAILURE;
 
-    struct cfgitems* it;
-    for (it = cfgitems_start_addr; it < cfgitems_end_addr; ++it)
-        if (it->module != NULL)
-            cfgitems_add(n++, it);
+    if ((buf == NULL) && (size != 0))
+        return CFGITEMS_FAILURE;
 
-    n_cfgitems = n;
+    /* snapshots see the whole configuration applied or none of it */
+    cfgitems_snapshot_begin_update();
+    cfgitems_parser_init(&parser, false);
+    cfgitems_parse_configuration(&parser, buf, size);
+    cfgitems_snapshot_end_update();
 
-    return filename ? cfgitems_parse_configuration_file(filename) : CFGITEMS_SUCCESS;
+    return CFGITEMS_SUCCESS;
 }
 
-int cfgitems_parse(const char* filename)
+int cfgitems_parse_fd(int fd)
+{
+    struct cfgitems_parser parser;
+    int retval;
+
+    if (cfgitems_frozen)
+        return CFGITEMS_FAILURE;
+
+    if (fd < 0)
+        return CFGITEMS_FAILURE;
+
+    cfgitems_parser_init(&parser, false);
+    retval = cfgitems_parse_stream(&parser, fd);
+
+    return retval;
+}
+
+int cfgitems_parse_changes(const char* filename)
 {
-    return filename ? cfgitems_parse_configuration_file(filename) : CFGITEMS_SUCCESS;
+    if (cfgitems_frozen)
+        return CFGITEMS_FAILURE;
+
+    return cfgitems_parse_configuration_file(filename, true);
 }
 
-int cfgitems_get_bool(const char* module, const char* name, bool* value)
+int cfgitems_load_compiled(const char* filename)
+{
+    struct stat st;
+    void* map;
+    int retval;
+    int fd;
+
+    if (cfgitems_frozen)
+        return CFGITEMS_FAILURE;
+
+    if ((filename == NULL) || (cfgitems_order == NULL))
+        return CFGITEMS_FAILURE;
+
+    fd = open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "failed to open compiled configuration '%s': %m\n", filename);
+        return CFGITEMS_FAILURE;
+    }
+
+    if ((fstat(fd, &st) != 0) || !S_ISREG(st.st_mode) ||
+        (st.st_size < (off_t)sizeof(struct cfgitems_image_header))) {
+        fprintf(stderr, "'%s' is not a compiled configuration\n", filename);
+        close(fd);
+        return CFGITEMS_FAILURE;
+    }
+
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "failed to map compiled configuration '%s'\n", filename);
+        return CFGITEMS_FAILURE;
+    }
+
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+    retval = cfgitems_image_check(filename, map, st.st_size);
+    if (retval == CFGITEMS_SUCCESS)
+        retval = cfgitems_image_apply(map);
+
+    munmap(map, st.st_size);
+
+    return retval;
+}
+
+int cfgitems_freeze(void)
+{
+    int retval = CFGITEMS_SUCCESS;
+
+    if (cfgitems_order == NULL)
+        return CFGITEMS_FAILURE;
+
+    __atomic_store_n(&cfgitems_frozen, true, __ATOMIC_SEQ_CST);
+
+    if ((cfgitems_protect(&CFGITEMS_SECTION_START, &CFGITEMS_SECTION_END) != CFGITEMS_SUCCESS) ||
+        (cfgitems_protect(CFGITEMS_VALUES_SECTION_START, CFGITEMS_VALUES_SECTION_END) != CFGITEMS_SUCCESS) ||
+        (cfgitems_protect(CFGITEMS_INDEX_SECTION_START, CFGITEMS_INDEX_SECTION_END) != CFGITEMS_SUCCESS))
+        retval = CFGITEMS_FAILURE;
+
+    return retval;
+}
+
+int cfgitems_lookup(const char* module, const char* name, enum cfgitems_type type,
+    cfgitems_handle_t* handle)
 {
     struct cfgitems* cfgitem = cfgitems_find(module, name);
 
-    if (cfgitem)
+    if ((cfgitem == NULL) || (cfgitem->type != type))
+        return CFGITEMS_FAILURE;
+
+    if (handle)
+        *handle = cfgitem;
+
+    return CFGITEMS_SUCCESS;
+}
+
+int cfgitems_lookup_hashed(const char* module, const char* name, uint32_t hash,
+    enum cfgitems_type type, cfgitems_handle_t* handle)
+{
+    struct cfgitems* cfgitem = cfgitems_find_hashed(module, name, hash);
+
+    if ((cfgitem == NULL) || (cfgitem->type != type))
+        return CFGITEMS_FAILURE;
+
+    if (handle)
+        *handle = cfgitem;
+
+    return CFGITEMS_SUCCESS;
+}
+
+int cfgitems_foreach_in_module(const char* module, cfgitems_callback_t callback, void* arg)
+{
+    const struct cfgitems_module* m;
+
+    if (callback == NULL)
+        return CFGITEMS_FAILURE;
+
+    m = cfgitems_find_module(module);
+    if (m == NULL)
+        return CFGITEMS_FAILURE;
+
+    for (size_t i = m->first; i < m->first + m->count; ++i) {
+        int status = callback(cfgitems_at(i), arg);
+        if (status != CFGITEMS_SUCCESS)
+            return status;
+    }
+
+    return CFGITEMS_SUCCESS;
+}
+
+uint64_t cfgitems_filtered_misses(void)
+{
+    return __atomic_load_n(&cfgitems_bloom_rejections, __ATOMIC_RELAXED);
+}
+
+int cfgitems_get_cache_stats(struct cfgitems_cache_stats* stats)
+{
+    if (stats == NULL)
+        return CFGITEMS_FAILURE;
+
+    cfgitems_cache_stats(stats);
+
+    return CFGITEMS_SUCCESS;
+}
+
+int cfgitems_get_section_stats(struct cfgitems_section_stats* stats)
+{
+    if (stats == NULL)
+        return CFGITEMS_FAILURE;
+
+    stats->applied = __atomic_load_n(&cfgitems_sections_applied, __ATOMIC_RELAXED);
+    stats->skipped = __atomic_load_n(&cfgitems_sections_skipped, __ATOMIC_RELAXED);
+
+    return CFGITEMS_SUCCESS;
+}
+
+int cfgitems_get_bool(const char* module, const char* name, bool* value)
+{
+    return cfgitems_get_bool_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_get_bool_h(cfgitems_handle_t handle, bool* value)
+{
+    uint32_t seq;
+
+    if (handle)
         if (value)
-            *value = cfgitem->value._BOOL_;
+            do {
+                seq = cfgitems_read_begin(handle);
+                *value = handle->value->_BOOL_;
+            } while (cfgitems_read_retry(handle, seq));
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_set_bool(const char* module, const char* name, bool value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_set_bool_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_set_bool_h(cfgitems_handle_t handle, bool value)
+{
+    if (cfgitems_frozen)
+        return CFGITEMS_FAILURE;
 
-    if (cfgitem)
-        cfgitem->value._BOOL_ = value;
+    if (handle) {
+        cfgitems_write_begin(handle);
+        handle->value->_BOOL_ = value;
+        cfgitems_bind_update(handle);
+        cfgitems_section_touch(handle);
+        cfgitems_write_end(handle);
+        cfgitems_snapshot_touch();
+        cfgitems_notify(handle);
+    }
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_to_bool(const char* str, bool* value)
@@ -159,48 +535,123 @@ int cfgitems_to_bool(const char* str, bool* value)
 
 int cfgitems_get_string(const char* module, const char* name, const char** value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_get_string_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_get_string_h(cfgitems_handle_t handle, const char** value)
+{
+    uint32_t seq;
 
-    if (cfgitem)
+    if (handle)
         if (value)
-            *value = cfgitem->value._STRING_;
+            do {
+                seq = cfgitems_read_begin(handle);
+                *value = __atomic_load_n(&handle->value->_STRING_, __ATOMIC_ACQUIRE);
+            } while (cfgitems_read_retry(handle, seq));
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_set_string(const char* module, const char* name, const char* value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_set_string_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_set_string_h(cfgitems_handle_t handle, const char* value)
+{
+    if (cfgitems_frozen)
+        return CFGITEMS_FAILURE;
 
-    if (cfgitem) {
-        if (strlen(value) >= sizeof(cfgitem->strvalue))
+    if (handle) {
+        struct cfgitems_string* string = cfgitems_string_create(value);
+        if (string == NULL)
             return CFGITEMS_FAILURE;
-        strcpy(cfgitem->strvalue, value);
-        cfgitem->value._STRING_ = cfgitem->strvalue;
+        cfgitems_write_begin(handle);
+        string = cfgitems_string_replace(handle, string);
+        cfgitems_bind_update(handle);
+        cfgitems_section_touch(handle);
+        cfgitems_write_end(handle);
+        cfgitems_snapshot_touch();
+        cfgitems_string_retire(string);
+        cfgitems_notify(handle);
     }
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+}
+
+int cfgitems_copy_string(const char* module, const char* name, char* buf, size_t size)
+{
+    return cfgitems_copy_string_h(cfgitems_find(module, name), buf, size);
+}
+
+int cfgitems_copy_string_h(cfgitems_handle_t handle, char* buf, size_t size)
+{
+    uint32_t seq;
+    int status;
+
+    if ((handle == NULL) || (buf == NULL))
+        return CFGITEMS_FAILURE;
+
+    cfgitems_read_lock();
+
+    do {
+        const char* str;
+        size_t len;
+
+        seq = cfgitems_read_begin(handle);
+
+        str = __atomic_load_n(&handle->value->_STRING_, __ATOMIC_ACQUIRE);
+        len = str ? strnlen(str, size) : size;
+        status = len < size ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+        if (status == CFGITEMS_SUCCESS)
+            memcpy(buf, str, len + 1);
+    } while (cfgitems_read_retry(handle, seq));
+
+    cfgitems_read_unlock();
+
+    return status;
 }
 
 int cfgitems_get_double(const char* module, const char* name, double* value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_get_double_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_get_double_h(cfgitems_handle_t handle, double* value)
+{
+    uint32_t seq;
 
-    if (cfgitem)
+    if (handle)
         if (value)
-            *value = cfgitem->value._DOUBLE_;
+            do {
+                seq = cfgitems_read_begin(handle);
+                *value = handle->value->_DOUBLE_;
+            } while (cfgitems_read_retry(handle, seq));
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_set_double(const char* module, const char* name, double value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_set_double_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_set_double_h(cfgitems_handle_t handle, double value)
+{
+    if (cfgitems_frozen)
+        return CFGITEMS_FAILURE;
 
-    if (cfgitem)
-        cfgitem->value._DOUBLE_ = value;
+    if (handle) {
+        cfgitems_write_begin(handle);
+        handle->value->_DOUBLE_ = value;
+        cfgitems_bind_update(handle);
+        cfgitems_section_touch(handle);
+        cfgitems_write_end(handle);
+        cfgitems_snapshot_touch();
+        cfgitems_notify(handle);
+    }
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_to_double(const char* str, double* value)
@@ -236,23 +687,44 @@ int cfgitems_to_double(const char* str, double* value)
 
 int cfgitems_get_s8(const char* module, const char* name, int8_t* value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_get_s8_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_get_s8_h(cfgitems_handle_t handle, int8_t* value)
+{
+    uint32_t seq;
 
-    if (cfgitem)
+    if (handle)
         if (value)
-            *value = cfgitem->value._S8_;
+            do {
+                seq = cfgitems_read_begin(handle);
+                *value = handle->value->_S8_;
+            } while (cfgitems_read_retry(handle, seq));
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_set_s8(const char* module, const char* name, int8_t value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_set_s8_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_set_s8_h(cfgitems_handle_t handle, int8_t value)
+{
+    if (cfgitems_frozen)
+        return CFGITEMS_FAILURE;
 
-    if (cfgitem)
-        cfgitem->value._S8_ = value;
+    if (handle) {
+        cfgitems_write_begin(handle);
+        handle->value->_S8_ = value;
+        cfgitems_bind_update(handle);
+        cfgitems_section_touch(handle);
+        cfgitems_write_end(handle);
+        cfgitems_snapshot_touch();
+        cfgitems_notify(handle);
+    }
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_to_s8(const char* str, int8_t* value)
@@ -291,23 +763,44 @@ int cfgitems_to_s8(const char* str, int8_t* value)
 
 int cfgitems_get_u8(const char* module, const char* name, uint8_t* value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_get_u8_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_get_u8_h(cfgitems_handle_t handle, uint8_t* value)
+{
+    uint32_t seq;
 
-    if (cfgitem)
+    if (handle)
         if (value)
-            *value = cfgitem->value._U8_;
+            do {
+                seq = cfgitems_read_begin(handle);
+                *value = handle->value->_U8_;
+            } while (cfgitems_read_retry(handle, seq));
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_set_u8(const char* module, const char* name, uint8_t value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_set_u8_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_set_u8_h(cfgitems_handle_t handle, uint8_t value)
+{
+    if (cfgitems_frozen)
+        return CFGITEMS_FAILURE;
 
-    if (cfgitem)
-        cfgitem->value._U8_ = value;
+    if (handle) {
+        cfgitems_write_begin(handle);
+        handle->value->_U8_ = value;
+        cfgitems_bind_update(handle);
+        cfgitems_section_touch(handle);
+        cfgitems_write_end(handle);
+        cfgitems_snapshot_touch();
+        cfgitems_notify(handle);
+    }
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_to_u8(const char* str, uint8_t* value)
@@ -346,23 +839,44 @@ int cfgitems_to_u8(const char* str, uint8_t* value)
 
 int cfgitems_get_s16(const char* module, const char* name, int16_t* value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_get_s16_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_get_s16_h(cfgitems_handle_t handle, int16_t* value)
+{
+    uint32_t seq;
 
-    if (cfgitem)
+    if (handle)
         if (value)
-            *value = cfgitem->value._S16_;
+            do {
+                seq = cfgitems_read_begin(handle);
+                *value = handle->value->_S16_;
+            } while (cfgitems_read_retry(handle, seq));
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_set_s16(const char* module, const char* name, int16_t value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_set_s16_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_set_s16_h(cfgitems_handle_t handle, int16_t value)
+{
+    if (cfgitems_frozen)
+        return CFGITEMS_FAILURE;
 
-    if (cfgitem)
-        cfgitem->value._S16_ = value;
+    if (handle) {
+        cfgitems_write_begin(handle);
+        handle->value->_S16_ = value;
+        cfgitems_bind_update(handle);
+        cfgitems_section_touch(handle);
+        cfgitems_write_end(handle);
+        cfgitems_snapshot_touch();
+        cfgitems_notify(handle);
+    }
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_to_s16(const char* str, int16_t* value)
@@ -401,23 +915,44 @@ int cfgitems_to_s16(const char* str, int16_t* value)
 
 int cfgitems_get_u16(const char* module, const char* name, uint16_t* value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_get_u16_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_get_u16_h(cfgitems_handle_t handle, uint16_t* value)
+{
+    uint32_t seq;
 
-    if (cfgitem)
+    if (handle)
         if (value)
-            *value = cfgitem->value._U16_;
+            do {
+                seq = cfgitems_read_begin(handle);
+                *value = handle->value->_U16_;
+            } while (cfgitems_read_retry(handle, seq));
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_set_u16(const char* module, const char* name, uint16_t value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_set_u16_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_set_u16_h(cfgitems_handle_t handle, uint16_t value)
+{
+    if (cfgitems_frozen)
+        return CFGITEMS_FAILURE;
 
-    if (cfgitem)
-        cfgitem->value._U16_ = value;
+    if (handle) {
+        cfgitems_write_begin(handle);
+        handle->value->_U16_ = value;
+        cfgitems_bind_update(handle);
+        cfgitems_section_touch(handle);
+        cfgitems_write_end(handle);
+        cfgitems_snapshot_touch();
+        cfgitems_notify(handle);
+    }
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_to_u16(const char* str, uint16_t* value)
@@ -456,23 +991,44 @@ int cfgitems_to_u16(const char* str, uint16_t* value)
 
 int cfgitems_get_s32(const char* module, const char* name, int32_t* value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_get_s32_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_get_s32_h(cfgitems_handle_t handle, int32_t* value)
+{
+    uint32_t seq;
 
-    if (cfgitem)
+    if (handle)
         if (value)
-            *value = cfgitem->value._S32_;
+            do {
+                seq = cfgitems_read_begin(handle);
+                *value = handle->value->_S32_;
+            } while (cfgitems_read_retry(handle, seq));
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_set_s32(const char* module, const char* name, int32_t value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_set_s32_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_set_s32_h(cfgitems_handle_t handle, int32_t value)
+{
+    if (cfgitems_frozen)
+        return CFGITEMS_FAILURE;
 
-    if (cfgitem)
-        cfgitem->value._S32_ = value;
+    if (handle) {
+        cfgitems_write_begin(handle);
+        handle->value->_S32_ = value;
+        cfgitems_bind_update(handle);
+        cfgitems_section_touch(handle);
+        cfgitems_write_end(handle);
+        cfgitems_snapshot_touch();
+        cfgitems_notify(handle);
+    }
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_to_s32(const char* str, int32_t* value)
@@ -511,28 +1067,49 @@ int cfgitems_to_s32(const char* str, int32_t* value)
 
 int cfgitems_get_u32(const char* module, const char* name, uint32_t* value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_get_u32_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_get_u32_h(cfgitems_handle_t handle, uint32_t* value)
+{
+    uint32_t seq;
 
-    if (cfgitem)
+    if (handle)
         if (value)
-            *value = cfgitem->value._U32_;
+            do {
+                seq = cfgitems_read_begin(handle);
+                *value = handle->value->_U32_;
+            } while (cfgitems_read_retry(handle, seq));
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_set_u32(const char* module, const char* name, uint32_t value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
-
-    if (cfgitem)
-        cfgitem->value._U32_ = value;
-
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return cfgitems_set_u32_h(cfgitems_find(module, name), value);
 }
 
-int cfgitems_to_u32(const char* str, uint32_t* value)
+int cfgitems_set_u32_h(cfgitems_handle_t handle, uint32_t value)
 {
-    int retval = CFGITEMS_FAILURE;
+    if (cfgitems_frozen)
+        return CFGITEMS_FAILURE;
+
+    if (handle) {
+        cfgitems_write_begin(handle);
+        handle->value->_U32_ = value;
+        cfgitems_bind_update(handle);
+        cfgitems_section_touch(handle);
+        cfgitems_write_end(handle);
+        cfgitems_snapshot_touch();
+        cfgitems_notify(handle);
+    }
+
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+}
+
+int cfgitems_to_u32(const char* str, uint32_t* value)
+{
+    int retval = CFGITEMS_FAILURE;
 
     do {
         unsigned long int uli;
@@ -566,23 +1143,44 @@ int cfgitems_to_u32(const char* str, uint32_t* value)
 
 int cfgitems_get_s64(const char* module, const char* name, int64_t* value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_get_s64_h(cfgitems_find(module, name), value);
+}
 
-    if (cfgitem)
+int cfgitems_get_s64_h(cfgitems_handle_t handle, int64_t* value)
+{
+    uint32_t seq;
+
+    if (handle)
         if (value)
-            *value = cfgitem->value._S64_;
+            do {
+                seq = cfgitems_read_begin(handle);
+                *value = handle->value->_S64_;
+            } while (cfgitems_read_retry(handle, seq));
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_set_s64(const char* module, const char* name, int64_t value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_set_s64_h(cfgitems_find(module, name), value);
+}
 
-    if (cfgitem)
-        cfgitem->value._S64_ = value;
+int cfgitems_set_s64_h(cfgitems_handle_t handle, int64_t value)
+{
+    if (cfgitems_frozen)
+        return CFGITEMS_FAILURE;
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    if (handle) {
+        cfgitems_write_begin(handle);
+        handle->value->_S64_ = value;
+        cfgitems_bind_update(handle);
+        cfgitems_section_touch(handle);
+        cfgitems_write_end(handle);
+        cfgitems_snapshot_touch();
+        cfgitems_notify(handle);
+    }
+
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_to_s64(const char* str, int64_t* value)
@@ -621,23 +1219,44 @@ int cfgitems_to_s64(const char* str, int64_t* value)
 
 int cfgitems_get_u64(const char* module, const char* name, uint64_t* value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_get_u64_h(cfgitems_find(module, name), value);
+}
 
-    if (cfgitem)
+int cfgitems_get_u64_h(cfgitems_handle_t handle, uint64_t* value)
+{
+    uint32_t seq;
+
+    if (handle)
         if (value)
-            *value = cfgitem->value._U64_;
+            do {
+                seq = cfgitems_read_begin(handle);
+                *value = handle->value->_U64_;
+            } while (cfgitems_read_retry(handle, seq));
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_set_u64(const char* module, const char* name, uint64_t value)
 {
-    struct cfgitems* cfgitem = cfgitems_find(module, name);
+    return cfgitems_set_u64_h(cfgitems_find(module, name), value);
+}
+
+int cfgitems_set_u64_h(cfgitems_handle_t handle, uint64_t value)
+{
+    if (cfgitems_frozen)
+        return CFGITEMS_FAILURE;
 
-    if (cfgitem)
-        cfgitem->value._U64_ = value;
+    if (handle) {
+        cfgitems_write_begin(handle);
+        handle->value->_U64_ = value;
+        cfgitems_bind_update(handle);
+        cfgitems_section_touch(handle);
+        cfgitems_write_end(handle);
+        cfgitems_snapshot_touch();
+        cfgitems_notify(handle);
+    }
 
-    return cfgitem ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+    return handle ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
 }
 
 int cfgitems_to_u64(const char* str, uint64_t* value)
@@ -674,215 +1293,1142 @@ int cfgitems_to_u64(const char* str, uint64_t* value)
     return retval;
 }
 
+struct cfgitems_txn* cfgitems_txn_begin(void)
+{
+    return calloc(1, sizeof(struct cfgitems_txn));
+}
+
+int cfgitems_txn_set_bool(struct cfgitems_txn* txn, const char* module, const char* name,
+    bool value)
+{
+    struct cfgitems_txn_entry* e = cfgitems_txn_add(txn, module, name, CFGITEMS_TYPE_BOOL);
+
+    if (e)
+        e->value._BOOL_ = value;
+
+    return e ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+}
+
+int cfgitems_txn_set_string(struct cfgitems_txn* txn, const char* module, const char* name,
+    const char* value)
+{
+    struct cfgitems_txn_entry* e;
+
+    if (txn == NULL)
+        return CFGITEMS_FAILURE;
+
+    if ((value == NULL) || (strlen(value) >= CFGITEMS_STRING_MAX)) {
+        txn->failed = true;
+        return CFGITEMS_FAILURE;
+    }
+
+    e = cfgitems_txn_add(txn, module, name, CFGITEMS_TYPE_STRING);
+    if (e == NULL)
+        return CFGITEMS_FAILURE;
+
+    e->string_offset = cfgitems_txn_strdup(txn, value);
+    if (e->string_offset == SIZE_MAX) {
+        txn->failed = true;
+        return CFGITEMS_FAILURE;
+    }
+
+    return CFGITEMS_SUCCESS;
+}
+
+int cfgitems_txn_set_double(struct cfgitems_txn* txn, const char* module, const char* name,
+    double value)
+{
+    struct cfgitems_txn_entry* e = cfgitems_txn_add(txn, module, name, CFGITEMS_TYPE_DOUBLE);
+
+    if (e)
+        e->value._DOUBLE_ = value;
+
+    return e ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+}
+
+int cfgitems_txn_set_s8(struct cfgitems_txn* txn, const char* module, const char* name,
+    int8_t value)
+{
+    struct cfgitems_txn_entry* e = cfgitems_txn_add(txn, module, name, CFGITEMS_TYPE_S8);
+
+    if (e)
+        e->value._S8_ = value;
+
+    return e ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+}
+
+int cfgitems_txn_set_u8(struct cfgitems_txn* txn, const char* module, const char* name,
+    uint8_t value)
+{
+    struct cfgitems_txn_entry* e = cfgitems_txn_add(txn, module, name, CFGITEMS_TYPE_U8);
+
+    if (e)
+        e->value._U8_ = value;
+
+    return e ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+}
+
+int cfgitems_txn_set_s16(struct cfgitems_txn* txn, const char* module, const char* name,
+    int16_t value)
+{
+    struct cfgitems_txn_entry* e = cfgitems_txn_add(txn, module, name, CFGITEMS_TYPE_S16);
+
+    if (e)
+        e->value._S16_ = value;
+
+    return e ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+}
+
+int cfgitems_txn_set_u16(struct cfgitems_txn* txn, const char* module, const char* name,
+    uint16_t value)
+{
+    struct cfgitems_txn_entry* e = cfgitems_txn_add(txn, module, name, CFGITEMS_TYPE_U16);
+
+    if (e)
+        e->value._U16_ = value;
+
+    return e ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+}
+
+int cfgitems_txn_set_s32(struct cfgitems_txn* txn, const char* module, const char* name,
+    int32_t value)
+{
+    struct cfgitems_txn_entry* e = cfgitems_txn_add(txn, module, name, CFGITEMS_TYPE_S32);
+
+    if (e)
+        e->value._S32_ = value;
+
+    return e ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+}
+
+int cfgitems_txn_set_u32(struct cfgitems_txn* txn, const char* module, const char* name,
+    uint32_t value)
+{
+    struct cfgitems_txn_entry* e = cfgitems_txn_add(txn, module, name, CFGITEMS_TYPE_U32);
+
+    if (e)
+        e->value._U32_ = value;
+
+    return e ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+}
+
+int cfgitems_txn_set_s64(struct cfgitems_txn* txn, const char* module, const char* name,
+    int64_t value)
+{
+    struct cfgitems_txn_entry* e = cfgitems_txn_add(txn, module, name, CFGITEMS_TYPE_S64);
+
+    if (e)
+        e->value._S64_ = value;
+
+    return e ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+}
+
+int cfgitems_txn_set_u64(struct cfgitems_txn* txn, const char* module, const char* name,
+    uint64_t value)
+{
+    struct cfgitems_txn_entry* e = cfgitems_txn_add(txn, module, name, CFGITEMS_TYPE_U64);
+
+    if (e)
+        e->value._U64_ = value;
+
+    return e ? CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
+}
+
+int cfgitems_txn_commit(struct cfgitems_txn* txn)
+{
+    int retval;
+
+    if (txn == NULL)
+        return CFGITEMS_FAILURE;
+
+    retval = (txn->failed || cfgitems_frozen) ? CFGITEMS_FAILURE : cfgitems_txn_resolve(txn);
+    if (retval == CFGITEMS_SUCCESS)
+        retval = cfgitems_txn_apply(txn);
+
+    cfgitems_txn_abort(txn);
+
+    return retval;
+}
+
+void cfgitems_txn_abort(struct cfgitems_txn* txn)
+{
+    if (txn == NULL)
+        return;
+
+    free(txn->strings);
+    free(txn->entries);
+    free(txn);
+}
+
 /*===========================================================================*\
  * local (internal linkage) function definitions
 \*===========================================================================*/
 static int cfgitems_compare(const struct cfgitems* l, const struct cfgitems* r)
 {
-    int status;
+    return cfgitems_compare_keys(l->module, l->name, r->module, r->name);
+}
 
-    status = strcmp(l->module, r->module);
-    if (status) {
-        if (!strcmp(l->module, CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE)))
-            return -1;
-        else
-        if (!strcmp(r->module, CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE)))
-            return +1;
-        else
-            return status;
+static int cfgitems_compare_indirect(const void* l, const void* r)
+{
+    return cfgitems_compare(&CFGITEMS_SECTION_START + *(const uint32_t*)l,
+                            &CFGITEMS_SECTION_START + *(const uint32_t*)r);
+}
+
+static int cfgitems_check_duplicates(void)
+{
+    int retval = CFGITEMS_SUCCESS;
+
+    for (size_t i = 1; i < n_cfgitems; ++i)
+        if (cfgitems_compare(cfgitems_at(i - 1), cfgitems_at(i)) == 0) {
+            fprintf(stderr, "configuration item '%s' in module '%s' is defined more than once\n",
+                cfgitems_at(i)->name, cfgitems_at(i)->module);
+            retval = CFGITEMS_FAILURE;
+        }
+
+    return retval;
+}
+
+static int cfgitems_use_presorted_index(size_t n_entries)
+{
+    const struct cfgitems_index_header* header =
+        (const struct cfgitems_index_header*)CFGITEMS_INDEX_SECTION_START;
+    size_t n_words = CFGITEMS_INDEX_SECTION_END - CFGITEMS_INDEX_SECTION_START;
+
+    if (n_words < CFGITEMS_INDEX_HEADER_WORDS)
+        return CFGITEMS_FAILURE;
+
+    if ((header->magic != CFGITEMS_INDEX_MAGIC) ||
+        (header->version != CFGITEMS_INDEX_VERSION) ||
+        (header->n_entries != n_entries) ||
+        (header->n_items >= n_entries) ||
+        (header->n_modules > header->n_items) ||
+        (n_words < cfgitems_index_words(header->n_items, header->n_modules)))
+        return CFGITEMS_FAILURE; /* binary was not processed by cfgitems-presort */
+
+    cfgitems_order = (const uint32_t*)(header + 1);
+    n_cfgitems = header->n_items;
+
+    cfgitems_hash = (const struct cfgitems_hash_slot*)(cfgitems_order + n_cfgitems);
+    n_cfgitems_hash = cfgitems_index_table_size(n_cfgitems);
+
+    cfgitems_modules = (const struct cfgitems_module*)(cfgitems_hash + n_cfgitems_hash);
+    n_cfgitems_modules = header->n_modules;
+
+    cfgitems_modules_hash = (const struct cfgitems_hash_slot*)(cfgitems_modules + n_cfgitems_modules);
+    n_cfgitems_modules_hash = cfgitems_hash_size(n_cfgitems_modules);
+
+    cfgitems_bloom = (const uint32_t*)(cfgitems_modules_hash + n_cfgitems_modules_hash);
+    n_cfgitems_bloom = cfgitems_bloom_words(n_cfgitems);
+
+    cfgitems_presorted = true;
+
+    __atomic_add_fetch(&cfgitems_generation, 1, __ATOMIC_RELEASE);
+
+    return CFGITEMS_SUCCESS;
+}
+
+static int cfgitems_build_index(size_t n_entries)
+{
+    struct cfgitems* const cfgitems_start_addr = &CFGITEMS_SECTION_START;
+    uint32_t* order;
+    struct cfgitems_hash_slot* entries;
+    struct cfgitems_hash_slot* hash;
+    size_t n = 0;
+
+    order = calloc(n_entries, sizeof(uint32_t));
+    entries = calloc(n_entries, sizeof(struct cfgitems_hash_slot));
+    hash = calloc(cfgitems_index_table_size(n_entries), sizeof(struct cfgitems_hash_slot));
+    if ((order == NULL) || (entries == NULL) || (hash == NULL)) {
+        free(order);
+        free(entries);
+        free(hash);
+        return CFGITEMS_FAILURE;
     }
 
-    status = strcmp(l->name, r->name);
+    for (size_t i = 0; i < n_entries; ++i) {
+        struct cfgitems* it = &cfgitems_start_addr[i];
 
-    return status;
+        if (it->module == NULL)
+            continue;
+
+        /* items defined in C++ come with the hash computed at compile time */
+        if (it->hash == 0)
+            it->hash = cfgitems_hash_key(it->module, it->name);
+
+        entries[n].hash = it->hash;
+        entries[n].id = i + 1;
+        order[n++] = i;
+    }
+
+    cfgitems_index_table_build(hash, cfgitems_index_table_size(n), entries, n);
+    free(entries);
+
+    qsort(order, n, sizeof(uint32_t), cfgitems_compare_indirect);
+
+    cfgitems_order = order;
+    n_cfgitems = n;
+
+    cfgitems_hash = hash;
+    n_cfgitems_hash = cfgitems_index_table_size(n);
+
+    cfgitems_presorted = false;
+
+    if ((cfgitems_check_duplicates() != CFGITEMS_SUCCESS) ||
+        (cfgitems_build_modules() != CFGITEMS_SUCCESS) ||
+        (cfgitems_build_bloom() != CFGITEMS_SUCCESS)) {
+        cfgitems_release();
+        return CFGITEMS_FAILURE;
+    }
+
+    __atomic_add_fetch(&cfgitems_generation, 1, __ATOMIC_RELEASE);
+
+    return CFGITEMS_SUCCESS;
 }
 
-static void cfgitems_add(size_t n_options, struct cfgitems* it)
+static int cfgitems_build_modules(void)
 {
-    size_t i;
+    struct cfgitems_module* modules;
+    struct cfgitems_hash_slot* hash;
+    const char* previous = NULL;
+    size_t n = 0;
 
-    for (i = 0; i < n_options; ++i)
-        if (cfgitems_compare(it, cfgitems[i]) < 0)
-            break;
+    modules = calloc(n_cfgitems ? n_cfgitems : 1, sizeof(struct cfgitems_module));
+    if (modules == NULL)
+        return CFGITEMS_FAILURE;
+
+    for (size_t i = 0; i < n_cfgitems; ++i) {
+        n = cfgitems_module_add(modules, n, cfgitems_at(i)->module, previous, i);
+        previous = cfgitems_at(i)->module;
+    }
+
+    hash = calloc(cfgitems_hash_size(n) ? cfgitems_hash_size(n) : 1, sizeof(struct cfgitems_hash_slot));
+    if (hash == NULL) {
+        free(modules);
+        return CFGITEMS_FAILURE;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        cfgitems_hash_insert(hash, cfgitems_hash_size(n), modules[i].hash, i);
+
+    cfgitems_modules = modules;
+    n_cfgitems_modules = n;
+
+    cfgitems_modules_hash = hash;
+    n_cfgitems_modules_hash = cfgitems_hash_size(n);
+
+    return CFGITEMS_SUCCESS;
+}
+
+static int cfgitems_build_bloom(void)
+{
+    uint32_t* bloom;
+
+    bloom = calloc(cfgitems_bloom_words(n_cfgitems), sizeof(uint32_t));
+    if (bloom == NULL)
+        return CFGITEMS_FAILURE;
+
+    for (size_t i = 0; i < n_cfgitems; ++i)
+        cfgitems_bloom_add(bloom, cfgitems_bloom_words(n_cfgitems), cfgitems_at(i)->hash);
+
+    cfgitems_bloom = bloom;
+    n_cfgitems_bloom = cfgitems_bloom_words(n_cfgitems);
+
+    return CFGITEMS_SUCCESS;
+}
+
+/*
+ * Sections are not essential, when they cannot be allocated
+ * the parser just applies all of them.
+ */
+static void cfgitems_build_sections(size_t n_entries)
+{
+    struct cfgitems_section* sections;
+    uint32_t* item_sections;
+
+    sections = calloc(n_cfgitems_modules ? n_cfgitems_modules : 1, sizeof(struct cfgitems_section));
+    item_sections = calloc(n_entries, sizeof(uint32_t));
+    if ((sections == NULL) || (item_sections == NULL)) {
+        free(sections);
+        free(item_sections);
+        return;
+    }
 
-    memmove(cfgitems + i + 1, cfgitems + i, (n_options - i) * sizeof(struct cfgitems*));
-    cfgitems[i] = it;
+    for (size_t i = 0; i < n_cfgitems_modules; ++i)
+        for (size_t k = 0; k < cfgitems_modules[i].count; ++k)
+            item_sections[cfgitems_order[cfgitems_modules[i].first + k]] = (uint32_t)i;
+
+    cfgitems_item_sections = item_sections;
+    __atomic_store_n(&cfgitems_sections, sections, __ATOMIC_RELEASE);
+}
+
+static void cfgitems_release(void)
+{
+    if (!cfgitems_presorted) {
+        free((void*)cfgitems_bloom);
+        free((void*)cfgitems_modules_hash);
+        free((void*)cfgitems_modules);
+        free((void*)cfgitems_hash);
+        free((void*)cfgitems_order);
+    }
+
+    cfgitems_bloom = NULL;
+    n_cfgitems_bloom = 0;
+
+    cfgitems_modules_hash = NULL;
+    n_cfgitems_modules_hash = 0;
+
+    cfgitems_modules = NULL;
+    n_cfgitems_modules = 0;
+
+    cfgitems_hash = NULL;
+    n_cfgitems_hash = 0;
+
+    cfgitems_order = NULL;
+    n_cfgitems = 0;
+
+    cfgitems_presorted = false;
+
+    __atomic_add_fetch(&cfgitems_generation, 1, __ATOMIC_RELEASE);
 }
 
 static struct cfgitems* cfgitems_find(const char* module, const char* name)
 {
-    size_t l = 0;
-    size_t r = n_cfgitems - 1;
+    uint32_t generation;
+    struct cfgitems* cfgitem;
 
     if (name == NULL)
         return NULL;
 
-    if (cfgitems == NULL)
+    if (module == NULL)
+        module = CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE);
+
+    generation = __atomic_load_n(&cfgitems_generation, __ATOMIC_ACQUIRE);
+
+    if (cfgitems_cache.record == NULL)
+        cfgitems_cache.record = cfgitems_cache_record();
+
+    cfgitem = cfgitems_cache_find(&cfgitems_cache, generation, module, name);
+    if (cfgitem != NULL)
+        return cfgitem;
+
+    cfgitem = cfgitems_find_hashed(module, name, cfgitems_hash_key(module, name));
+    if (cfgitem != NULL)
+        cfgitems_cache_insert(&cfgitems_cache, generation, module, name, cfgitem);
+
+    return cfgitem;
+}
+
+static struct cfgitems* cfgitems_find_hashed(const char* module, const char* name, uint32_t hash)
+{
+    if (name == NULL)
+        return NULL;
+
+    if (cfgitems_hash == NULL)
         return NULL;
 
     if (module == NULL)
         module = CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE);
 
-    const struct cfgitems x = {.module = module, .name = name};
-    while (l <= r) {
-        size_t m = (l + r) / 2;
-        int status = cfgitems_compare(cfgitems[m], &x);
+    if (cfgitems_filtered_out(hash))
+        return NULL;
 
-        if (status < 0)
-            l = m + 1;
-        else
-        if (status > 0)
-            r = m - 1;
-        else
-            return cfgitems[m];
-    }
+    return cfgitems_index_table_find(cfgitems_hash, n_cfgitems_hash, &CFGITEMS_SECTION_START,
+        hash, module, name);
+}
 
-    return NULL;
+static const struct cfgitems_module* cfgitems_find_module(const char* module)
+{
+    if (module == NULL)
+        module = CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE);
+
+    return cfgitems_find_module_span(module, strlen(module));
 }
 
-static int cfgitems_parse_configuration_line(const char* module, char* line)
+static const struct cfgitems_module* cfgitems_find_module_span(const char* module, size_t len)
 {
-    int retval = CFGITEMS_FAILURE;
+    if (cfgitems_modules_hash == NULL)
+        return NULL;
 
-    static const char* delimiters = "\t =";
+    return cfgitems_module_find(cfgitems_modules_hash, n_cfgitems_modules_hash, cfgitems_modules,
+        &CFGITEMS_SECTION_START, cfgitems_order,
+        cfgitems_module_hash(cfgitems_hash_span(CFGITEMS_HASH_OFFSET_BASIS, module, len)),
+        module, len);
+}
 
-    do {
-        char* name;
-        char* value;
-        struct cfgitems* cfgitem;
-        int status;
+static struct cfgitems* cfgitems_find_in_module(const struct cfgitems_module* m, const char* name,
+    size_t len)
+{
+    uint32_t hash;
 
-        name = strtok(line, delimiters);
-        if (name == NULL)
-            break;
+    if (m == NULL)
+        return NULL;
 
-        cfgitem = cfgitems_find(module, name);
-        if (cfgitem == NULL)
-            break;
+    /* the module is already hashed, only the name has to be fed into the hash */
+    hash = cfgitems_hash_final(cfgitems_hash_span(m->state, name, len));
 
-        value = strtok(NULL, delimiters);
-        if (value == NULL)
-            break;
+    /* most of the keys of a shared configuration file are not ours */
+    if (cfgitems_filtered_out(hash))
+        return NULL;
 
-        if (value[0] == '\"')
-            value++;
-        size_t value_len = strlen(value);
-        if ((value_len > 0) && value[value_len - 1] == '\"')
-            value[value_len - 1] = '\0';
+    return cfgitems_index_table_find_span(cfgitems_hash, n_cfgitems_hash, &CFGITEMS_SECTION_START,
+        hash, cfgitems_at(m->first)->module, name, len);
+}
 
+/*
+ * Tells whether the item already has the parsed value (the converted 'any'
+ * or, for strings, the span of 'len' characters). Like any other reader
+ * it never waits for the writers of the item.
+ */
+static bool cfgitems_parse_is_current(struct cfgitems* cfgitem, const char* value, size_t len,
+    const union cfgitems_any* any)
+{
+    uint32_t seq;
+    bool equal;
+
+    if (cfgitem->type == CFGITEMS_TYPE_STRING) {
+        cfgitems_read_lock();
+        do {
+            const char* str;
+
+            seq = cfgitems_read_begin(cfgitem);
+            str = __atomic_load_n(&cfgitem->value->_STRING_, __ATOMIC_ACQUIRE);
+            /* spans never contain null characters */
+            equal = (str != NULL) && !strncmp(str, value, len) && (str[len] == '\0');
+        } while (cfgitems_read_retry(cfgitem, seq));
+        cfgitems_read_unlock();
+
+        return equal;
+    }
+
+    do {
+        seq = cfgitems_read_begin(cfgitem);
         switch (cfgitem->type) {
-            case CFGITEMS_TYPE_BOOL:
-                status = cfgitems_to_bool(value, &cfgitem->value._BOOL_);
+            case CFGITEMS_TYPE_BOOL: equal = cfgitem->value->_BOOL_ == any->_BOOL_; break;
+            /* bitwise, so that NaN stays NaN and -0.0 differs from 0.0 */
+            case CFGITEMS_TYPE_DOUBLE:
+                equal = !memcmp(&cfgitem->value->_DOUBLE_, &any->_DOUBLE_, sizeof(double));
                 break;
+            case CFGITEMS_TYPE_S8: equal = cfgitem->value->_S8_ == any->_S8_; break;
+            case CFGITEMS_TYPE_U8: equal = cfgitem->value->_U8_ == any->_U8_; break;
+            case CFGITEMS_TYPE_S16: equal = cfgitem->value->_S16_ == any->_S16_; break;
+            case CFGITEMS_TYPE_U16: equal = cfgitem->value->_U16_ == any->_U16_; break;
+            case CFGITEMS_TYPE_S32: equal = cfgitem->value->_S32_ == any->_S32_; break;
+            case CFGITEMS_TYPE_U32: equal = cfgitem->value->_U32_ == any->_U32_; break;
+            case CFGITEMS_TYPE_S64: equal = cfgitem->value->_S64_ == any->_S64_; break;
+            case CFGITEMS_TYPE_U64: equal = cfgitem->value->_U64_ == any->_U64_; break;
+            default: equal = false; break;
+        }
+    } while (cfgitems_read_retry(cfgitem, seq));
+
+    return equal;
+}
+
+/*
+ * Applies the 'name = value' line of the current section.
+ */
+static int cfgitems_parse_configuration_line(struct cfgitems_parser* parser,
+    const struct cfgitems_token* token)
+{
+    const char* value = token->value;
+    size_t value_len = token->value_len;
+    struct cfgitems* cfgitem;
+    struct cfgitems_string* string = NULL;
+    union cfgitems_any any;
+
+    cfgitem = cfgitems_find_in_module(parser->m, token->name, token->name_len);
+    if (cfgitem == NULL)
+        return CFGITEMS_FAILURE;
+
+    if (value_len == 0)
+        return CFGITEMS_FAILURE;
+
+    if (value[0] == '\"')
+        value++, value_len--;
+    if ((value_len > 0) && (value[value_len - 1] == '\"'))
+        value_len--;
+
+    /* strings are compared before they are copied */
+    if ((cfgitem->type == CFGITEMS_TYPE_STRING) && parser->changes_only &&
+        cfgitems_parse_is_current(cfgitem, value, value_len, NULL))
+        return CFGITEMS_SUCCESS;
+
+    /* values are converted (and strings copied) before the item is written */
+    if (cfgitem->type == CFGITEMS_TYPE_STRING) {
+        string = cfgitems_string_create_n(value, value_len);
+        if (string == NULL)
+            return CFGITEMS_FAILURE;
+    }
+    else
+    if (cfgitems_span_to_any(cfgitem->type, value, value_len, &any) != CFGITEMS_SUCCESS)
+        return CFGITEMS_FAILURE;
+    else
+    if (parser->changes_only && cfgitems_parse_is_current(cfgitem, value, value_len, &any))
+        return CFGITEMS_SUCCESS;
+
+    cfgitems_write_begin(cfgitem);
+
+    /* a new string is published as a whole, it is never written in place */
+    if (string != NULL)
+        string = cfgitems_string_replace(cfgitem, string);
+    else
+        *cfgitem->value = any;
+
+    cfgitems_bind_update(cfgitem);
+    cfgitems_section_touch(cfgitem);
+    parser->writes++;
+
+    cfgitems_write_end(cfgitem);
+    cfgitems_snapshot_touch();
+
+    cfgitems_string_retire(string);
+
+    cfgitems_notify(cfgitem);
+
+    return CFGITEMS_SUCCESS;
+}
+
+/*
+ * Parses the lines held in the buffer. The buffer is only read,
+ * it is tokenized (see cfgitems_scan()) in batches of CFGITEMS_PARSE_TOKENS
+ * lines, which are then applied. The buffer has to end with a complete line,
+ * it begins in the section of the parser (updated to the section
+ * it ends in).
+ */
+static void cfgitems_parse_lines(struct cfgitems_parser* parser, const char* buf, size_t size)
+{
+    struct cfgitems_token tokens[CFGITEMS_PARSE_TOKENS];
+    struct cfgitems_scanner scanner;
+    size_t n;
+
+    cfgitems_scanner_init(&scanner, buf, size);
+
+    /* modules are resolved once per section, not for each of its lines */
+    while ((n = cfgitems_scan(&scanner, tokens, CFGITEMS_PARSE_TOKENS)) > 0)
+        for (size_t i = 0; i < n; ++i) {
+            if (tokens[i].type == CFGITEMS_TOKEN_SECTION)
+                parser->m = cfgitems_find_module_span(tokens[i].name, tokens[i].name_len);
+            else
+            if (parser->m != NULL) /* lines of unknown modules can be skipped altogether */
+                cfgitems_parse_configuration_line(parser, &tokens[i]);
+        }
+}
+
+/*
+ * Finds the next '[name]' line, i.e. the line beginning at or after 'lines'
+ * (which is the beginning of a line) the tokenizer makes a section of.
+ * Only the candidate lines (those with '[' at all) are tokenized.
+ *
+ * @return Beginning of the line ('end' if there is none), its token
+ *         and the beginning of the line which follows it.
+ */
+static const char* cfgitems_parse_next_section(const char* lines, const char* end,
+    struct cfgitems_token* token, const char** next_lines)
+{
+    struct cfgitems_scanner scanner;
+    const char* c;
+
+    for (c = lines; (c = memchr(c, '[', end - c)) != NULL; ) {
+        const char* line = c;
+        const char* eol = memchr(c, '\n', end - c);
+
+        eol = eol ? eol + 1 : end;
+
+        while ((line > lines) && (line[-1] != '\n'))
+            line--;
+
+        cfgitems_scanner_init(&scanner, line, eol - line);
+        if ((cfgitems_scan(&scanner, token, 1) == 1) && (token->type == CFGITEMS_TOKEN_SECTION)) {
+            *next_lines = scanner.next;
+            return line;
+        }
+
+        /* the rest of the line cannot begin a section */
+        c = eol;
+    }
+
+    *next_lines = end;
 
-            case CFGITEMS_TYPE_STRING:
-                status = strlen(value) < sizeof(cfgitem->strvalue) ?
-                    CFGITEMS_SUCCESS : CFGITEMS_FAILURE;
-                if (status == CFGITEMS_SUCCESS) {
-                    strcpy(cfgitem->strvalue, value);
-                    cfgitem->value._STRING_ = cfgitem->strvalue;
+    return end;
+}
+
+/*
+ * Splits the configuration into its sections (including the lines preceding
+ * the first one, which belong to the global module). Sections of unknown
+ * modules and empty ones are left out, the parser ends in the module
+ * of the last section.
+ *
+ * @return Number of the sections, (size_t)-1 if they could not be allocated.
+ */
+static size_t cfgitems_parse_sections(struct cfgitems_parser* parser, const char* buf,
+    size_t size, struct cfgitems_parse_section** sections)
+{
+    const char* const end = buf + size;
+    const char* begin = buf;
+    const char* lines = buf;
+    struct cfgitems_token token;
+    size_t n = 0, capacity = 0;
+
+    *sections = NULL;
+
+    while (begin < end) {
+        const char* next_lines;
+        const char* next = cfgitems_parse_next_section(lines, end, &token, &next_lines);
+
+        if ((parser->m != NULL) && (begin != next)) {
+            if (n == capacity) {
+                struct cfgitems_parse_section* grown;
+
+                capacity = capacity ? 2 * capacity : 16;
+                grown = realloc(*sections, capacity * sizeof(struct cfgitems_parse_section));
+                if (grown == NULL) {
+                    free(*sections);
+                    *sections = NULL;
+                    return (size_t)-1;
                 }
-                break;
+                *sections = grown;
+            }
 
-            case CFGITEMS_TYPE_DOUBLE:
-                status = cfgitems_to_double(value, &cfgitem->value._DOUBLE_);
-                break;
+            (*sections)[n++] = (struct cfgitems_parse_section){ parser->m, begin, lines, next };
+        }
 
-            case CFGITEMS_TYPE_S8:
-                status = cfgitems_to_s8(value, &cfgitem->value._S8_);
-                break;
+        if (next < end)
+            parser->m = cfgitems_find_module_span(token.name, token.name_len);
 
-            case CFGITEMS_TYPE_U8:
-              status = cfgitems_to_u8(value, &cfgitem->value._U8_);
-                break;
+        begin = next;
+        lines = next_lines;
+    }
 
-            case CFGITEMS_TYPE_S16:
-               status = cfgitems_to_s16(value, &cfgitem->value._S16_);
-                break;
+    return n;
+}
 
-            case CFGITEMS_TYPE_U16:
-               status = cfgitems_to_u16(value, &cfgitem->value._U16_);
-                break;
+/*
+ * Parses the whole configuration held in the buffer. The sections
+ * of each module are digested together, in their order, and applied
+ * only if any of them has changed. They are skipped all at once when
+ * they are the very ones applied last to the items of the module
+ * and nothing else has written them since (a module may have several
+ * sections, applying only some of them would not set its items
+ * the way the whole configuration does).
+ */
+static void cfgitems_parse_configuration(struct cfgitems_parser* parser, const char* buf,
+    size_t size)
+{
+    struct cfgitems_section* state = __atomic_load_n(&cfgitems_sections, __ATOMIC_ACQUIRE);
+    const struct cfgitems_module* m = parser->m;
+    struct cfgitems_parse_section* sections;
+    struct cfgitems_parse_module* modules;
+    size_t n;
+
+    n = cfgitems_parse_sections(parser, buf, size, &sections);
+    modules = (state != NULL) && (n != (size_t)-1) ?
+        calloc(n_cfgitems_modules ? n_cfgitems_modules : 1, sizeof(struct cfgitems_parse_module)) : NULL;
+
+    if (modules == NULL) {
+        /* without the sections they are all applied */
+        parser->m = m;
+        cfgitems_parse_lines(parser, buf, size);
+        free(sections);
+        return;
+    }
 
-            case CFGITEMS_TYPE_S32:
-               status = cfgitems_to_s32(value, &cfgitem->value._S32_);
-                break;
+    for (size_t i = 0; i < n; ++i) {
+        struct cfgitems_parse_module* module = &modules[sections[i].m - cfgitems_modules];
 
-            case CFGITEMS_TYPE_U32:
-               status = cfgitems_to_u32(value, &cfgitem->value._U32_);
-                break;
+        module->sections++;
+        module->digest = cfgitems_digest_merge(module->digest,
+            cfgitems_digest(sections[i].begin, sections[i].end - sections[i].begin));
+    }
 
-            case CFGITEMS_TYPE_S64:
-               status = cfgitems_to_s64(value, &cfgitem->value._S64_);
-                break;
+    for (size_t i = 0; i < n_cfgitems_modules; ++i)
+        if (modules[i].sections > 0) {
+            modules[i].writes = __atomic_load_n(&state[i].writes, __ATOMIC_ACQUIRE);
+            modules[i].apply = __atomic_load_n(&state[i].key, __ATOMIC_ACQUIRE) !=
+                cfgitems_section_key(modules[i].digest, modules[i].writes);
 
-            case CFGITEMS_TYPE_U64:
-              status = cfgitems_to_u64(value, &cfgitem->value._U64_);
-                break;
+            if (!modules[i].apply)
+                __atomic_add_fetch(&cfgitems_sections_skipped, modules[i].sections, __ATOMIC_RELAXED);
+        }
+
+    m = parser->m;
+
+    for (size_t i = 0; i < n; ++i) {
+        struct cfgitems_parse_module* module = &modules[sections[i].m - cfgitems_modules];
+
+        if (!module->apply)
+            continue;
+
+        parser->m = sections[i].m;
+        parser->writes = 0;
+        cfgitems_parse_lines(parser, sections[i].lines, sections[i].end - sections[i].lines);
+        module->writes += parser->writes;
+
+        __atomic_add_fetch(&cfgitems_sections_applied, 1, __ATOMIC_RELAXED);
+    }
+
+    parser->m = m;
+
+    /* unless the items have been written by somebody else meanwhile */
+    for (size_t i = 0; i < n_cfgitems_modules; ++i)
+        if (modules[i].apply) {
+            uint64_t key = (__atomic_load_n(&state[i].writes, __ATOMIC_ACQUIRE) == modules[i].writes) ?
+                cfgitems_section_key(modules[i].digest, modules[i].writes) : 0;
+            __atomic_store_n(&state[i].key, key, __ATOMIC_RELEASE);
+        }
+
+    free(modules);
+    free(sections);
+}
+
+/*
+ * Reads the configuration from the descriptor (until the end of the input)
+ * and parses each part of it as soon as it has been read (see cfgitems_parse_fd()).
+ */
+static int cfgitems_parse_stream(struct cfgitems_parser* parser, int fd)
+{
+    size_t capacity = CFGITEMS_PARSE_CHUNK;
+    size_t size = 0;
+    int retval = CFGITEMS_SUCCESS;
+    char* buf;
+
+    buf = malloc(capacity);
+    if (buf == NULL)
+        return CFGITEMS_FAILURE;
+
+    /* the buffer holds the incomplete line read last, followed by the new input */
+    for (;;) {
+        const char* eol;
+        ssize_t n;
 
-            default:
-                status = CFGITEMS_FAILURE;
+        /* the line does not fit, the buffer has to grow */
+        if (size == capacity) {
+            char* p = realloc(buf, 2 * capacity);
+            if (p == NULL) {
+                retval = CFGITEMS_FAILURE;
                 break;
+            }
+            buf = p, capacity *= 2;
         }
 
-        retval = status;
-    } while (0);
+        n = read(fd, buf + size, capacity - size);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            retval = CFGITEMS_FAILURE;
+            break;
+        }
+
+        if (n == 0)
+            break;
+
+        /* complete lines are parsed as soon as they have been read */
+        eol = cfgitems_parse_last_eol(buf + size, n);
+        size += n;
+        if (eol != NULL) {
+            size_t len = eol + 1 - buf;
+            cfgitems_parse_lines(parser, buf, len);
+            memmove(buf, buf + len, size - len);
+            size -= len;
+        }
+    }
+
+    /* the last line does not need to end with a newline */
+    if (retval == CFGITEMS_SUCCESS)
+        cfgitems_parse_lines(parser, buf, size);
+
+    free(buf);
 
     return retval;
 }
 
-static int cfgitems_parse_configuration_file(const char* filename)
+/*
+ * Regular files are mapped and parsed in place, anything else
+ * (pipes, character devices, ...) is streamed.
+ */
+static int cfgitems_parse_configuration_file(const char* filename, bool changes_only)
 {
-    FILE *fp;
-    int status;
-    char buf[1024];
-    char module[1024];
-    char* line;
-    char* c;
+    struct cfgitems_parser parser;
+    struct stat st;
+    int retval = CFGITEMS_SUCCESS;
+    int fd;
 
-    fp = fopen(filename, "r");
-    if (fp == NULL) {
+    fd = open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
         fprintf(stderr, "failed to open configuration file '%s': %m\n", filename);
         return CFGITEMS_FAILURE;
     }
 
-    status = cfgitems_strlcpy(module, CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE), sizeof(module));
-    if (status == CFGITEMS_FAILURE)
+    if ((fstat(fd, &st) == 0) && S_ISREG(st.st_mode) && (st.st_size > 0)) {
+        void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            madvise(map, st.st_size, MADV_SEQUENTIAL);
+            cfgitems_snapshot_begin_update();
+            cfgitems_parser_init(&parser, changes_only);
+            cfgitems_parse_configuration(&parser, map, st.st_size);
+            cfgitems_snapshot_end_update();
+            munmap(map, st.st_size);
+            close(fd);
+            return retval;
+        }
+    }
+
+    /* streamed configuration is applied (and seen by snapshots) as it is read */
+    cfgitems_parser_init(&parser, changes_only);
+    retval = cfgitems_parse_stream(&parser, fd);
+    close(fd);
+
+    return retval;
+}
+
+/*
+ * Digest of the keys and types of all the items, computed once.
+ */
+static uint64_t cfgitems_registry_digest(void)
+{
+    uint64_t registry = __atomic_load_n(&cfgitems_registry, __ATOMIC_RELAXED);
+
+    if (registry == 0) {
+        registry = CFGITEMS_IMAGE_VERSION;
+        for (size_t i = 0; i < n_cfgitems; ++i)
+            registry = cfgitems_image_registry(registry, cfgitems_at(i)->module,
+                cfgitems_at(i)->name, cfgitems_at(i)->type);
+        __atomic_store_n(&cfgitems_registry, registry, __ATOMIC_RELAXED);
+    }
+
+    return registry;
+}
+
+/*
+ * Checks the whole image before anything is applied: its format, its
+ * checksum and that each value belongs to an item of the very type.
+ */
+static int cfgitems_image_check(const char* filename, const struct cfgitems_image_header* header,
+    size_t size)
+{
+    const struct cfgitems_image_value* values = (const struct cfgitems_image_value*)(header + 1);
+
+    if ((header->magic != CFGITEMS_IMAGE_MAGIC) || (header->version != CFGITEMS_IMAGE_VERSION)) {
+        fprintf(stderr, "'%s' is not a compiled configuration (of version %u)\n",
+            filename, CFGITEMS_IMAGE_VERSION);
+        return CFGITEMS_FAILURE;
+    }
+
+    if (((size - sizeof(*header)) / sizeof(*values) < header->n_values) ||
+        (size - sizeof(*header) - header->n_values * sizeof(*values) != header->strings_size) ||
+        (cfgitems_digest((const char*)values, size - sizeof(*header)) != header->checksum)) {
+        fprintf(stderr, "compiled configuration '%s' is truncated or corrupted\n", filename);
+        return CFGITEMS_FAILURE;
+    }
+
+    if (header->registry != cfgitems_registry_digest()) {
+        fprintf(stderr, "compiled configuration '%s' does not match configuration items\n", filename);
         return CFGITEMS_FAILURE;
+    }
 
-    while ((c = fgets(buf, sizeof(buf), fp)) != NULL) {
+    for (uint32_t i = 0; i < header->n_values; ++i) {
+        const struct cfgitems_image_value* v = &values[i];
 
-        /* skip leading whitespace characters */
-        while (isspace(*c))
-            c++;
+        if ((v->item >= n_cfgitems) || (cfgitems_at(v->item)->hash != v->hash) ||
+            (cfgitems_at(v->item)->type != v->type) ||
+            ((v->type == CFGITEMS_TYPE_STRING) ?
+                (v->value > header->strings_size) || (v->length > header->strings_size - v->value) ||
+                (v->length >= CFGITEMS_STRING_MAX) :
+                (v->length != 0))) {
+            fprintf(stderr, "compiled configuration '%s' does not match configuration items\n", filename);
+            return CFGITEMS_FAILURE;
+        }
+    }
 
-        /* ignore comments and empty lines */
-        if (*c == ';' || *c == '#' || *c == '\n' || *c == '\0')
+    return CFGITEMS_SUCCESS;
+}
+
+/*
+ * Applies the values of the (already checked) image in a single pass.
+ * Strings are created up front, so that either all the values
+ * are applied or (when memory runs out) none of them.
+ */
+static int cfgitems_image_apply(const struct cfgitems_image_header* header)
+{
+    const struct cfgitems_image_value* values = (const struct cfgitems_image_value*)(header + 1);
+    const char* strings = (const char*)(values + header->n_values);
+    struct cfgitems_string** created;
+    uint32_t i;
+
+    created = calloc(header->n_values ? header->n_values : 1, sizeof(struct cfgitems_string*));
+    if (created == NULL)
+        return CFGITEMS_FAILURE;
+
+    for (i = 0; i < header->n_values; ++i) {
+        if (values[i].type != CFGITEMS_TYPE_STRING)
             continue;
 
-        line = c;
+        created[i] = cfgitems_string_create_n(strings + values[i].value, values[i].length);
+        if (created[i] == NULL) {
+            while (i-- > 0)
+                free(created[i]);
+            free(created);
+            return CFGITEMS_FAILURE;
+        }
+    }
+
+    cfgitems_snapshot_begin_update();
+
+    for (i = 0; i < header->n_values; ++i) {
+        struct cfgitems* cfgitem = cfgitems_at(values[i].item);
+
+        cfgitems_write_begin(cfgitem);
 
-        /* remove trailing whitespace characters */
-        c += strlen(line) - 1;
-        while (c > line && (isspace(*c)))
-            *c-- = '\0';
+        if (created[i] != NULL)
+            created[i] = cfgitems_string_replace(cfgitem, created[i]);
+        else
+            memcpy(cfgitem->value, &values[i].value, sizeof(union cfgitems_any));
+
+        cfgitems_bind_update(cfgitem);
+        cfgitems_section_touch(cfgitem);
+
+        cfgitems_write_end(cfgitem);
+    }
+
+    cfgitems_snapshot_end_update();
+
+    for (i = 0; i < header->n_values; ++i) {
+        cfgitems_string_retire(created[i]);
+        cfgitems_notify(cfgitems_at(values[i].item));
+    }
+
+    free(created);
+
+    return CFGITEMS_SUCCESS;
+}
+
+/*
+ * Write protects the pages lying entirely within [start, end).
+ * Those at the ends of the range may be shared with other data,
+ * thus they are left as they are.
+ */
+static int cfgitems_protect(const void* start, const void* end)
+{
+    uintptr_t page_size = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t first = ((uintptr_t)start + page_size - 1) & ~(page_size - 1);
+    uintptr_t last = (uintptr_t)end & ~(page_size - 1);
+
+    if (first >= last)
+        return CFGITEMS_SUCCESS;
+
+    return mprotect((void*)first, last - first, PROT_READ) ? CFGITEMS_FAILURE : CFGITEMS_SUCCESS;
+}
+
+static int cfgitems_txn_compare(const void* l, const void* r)
+{
+    const struct cfgitems_txn_entry* le = l;
+    const struct cfgitems_txn_entry* re = r;
+    int status;
+
+    status = cfgitems_compare_keys(le->module, le->name, re->module, re->name);
+    if (status)
+        return status;
+
+    /* updates of the same item are kept in the order they were staged in */
+    return (le->seqno > re->seqno) - (le->seqno < re->seqno);
+}
+
+/*
+ * Resolves all the updates of the transaction in a single pass. Updates
+ * are sorted the same way the items are, so each module is looked up
+ * only once and the names of its items are merged with those of the updates.
+ */
+static int cfgitems_txn_resolve(struct cfgitems_txn* txn)
+{
+    struct cfgitems_txn_entry* const end = txn->entries + txn->n_entries;
+    struct cfgitems_txn_entry* e;
+
+    for (e = txn->entries; e < end; ++e) {
+        e->module = txn->strings + e->module_offset;
+        e->name = txn->strings + e->name_offset;
+        if (e->type == CFGITEMS_TYPE_STRING)
+            e->value._STRING_ = txn->strings + e->string_offset;
+    }
+
+    qsort(txn->entries, txn->n_entries, sizeof(struct cfgitems_txn_entry), cfgitems_txn_compare);
+
+    for (e = txn->entries; e < end; ) {
+        const char* module = e->module;
+        const struct cfgitems_module* m;
+        size_t i, last;
+
+        m = cfgitems_find_module(module);
+        if (m == NULL)
+            return CFGITEMS_FAILURE;
+
+        for (i = m->first, last = m->first + m->count; (e < end) && !strcmp(e->module, module); ++e) {
+            int status = -1;
+
+            while ((i < last) && ((status = strcmp(cfgitems_at(i)->name, e->name)) < 0))
+                i++;
 
-        if (*line == '[') { /* section definition line */
-            line++;
-            if (*line == '\0' || *c != ']') /* go to the next line if this one */
-                continue;                   /* doesn't look like correct section definition line */
-            *c = '\0';
+            if ((status != 0) || (cfgitems_at(i)->type != e->type))
+                return CFGITEMS_FAILURE;
 
-            if (strlen(line) < sizeof(module))
-                strcpy(module, line);
+            e->cfgitem = cfgitems_at(i);
+        }
+    }
 
+    return CFGITEMS_SUCCESS;
+}
+
+/*
+ * Applies the resolved updates. All the items are locked (in the sorted order)
+ * before any of them is written and no snapshot is taken until all of them
+ * are unlocked again. Of the updates of the same item (which are adjacent)
+ * only the last one is applied (and notified). New strings are created
+ * up front, so that the batch can still be rejected as a whole.
+ */
+static int cfgitems_txn_apply(struct cfgitems_txn* txn)
+{
+    struct cfgitems_txn_entry* const end = txn->entries + txn->n_entries;
+    struct cfgitems_txn_entry* e;
+
+    for (e = txn->entries; e < end; ++e) {
+        if ((e->type != CFGITEMS_TYPE_STRING) || ((e + 1 != end) && (e[1].cfgitem == e->cfgitem)))
             continue;
+
+        e->string = cfgitems_string_create(e->value._STRING_);
+        if (e->string == NULL) {
+            while (e-- > txn->entries)
+                free(e->string);
+            return CFGITEMS_FAILURE;
         }
+    }
 
-        cfgitems_parse_configuration_line(module, line);
+    cfgitems_snapshot_begin_update();
+
+    for (e = txn->entries; e < end; ++e)
+        if ((e + 1 == end) || (e[1].cfgitem != e->cfgitem))
+            cfgitems_write_begin(e->cfgitem);
+
+    for (e = txn->entries; e < end; ++e) {
+        if ((e + 1 != end) && (e[1].cfgitem == e->cfgitem))
+            continue;
+
+        if (e->type == CFGITEMS_TYPE_STRING)
+            e->string = cfgitems_string_replace(e->cfgitem, e->string);
+        else
+            *e->cfgitem->value = e->value;
+
+        cfgitems_bind_update(e->cfgitem);
+        cfgitems_section_touch(e->cfgitem);
     }
 
-    fclose(fp);
+    for (e = txn->entries; e < end; ++e)
+        if ((e + 1 == end) || (e[1].cfgitem != e->cfgitem))
+            cfgitems_write_end(e->cfgitem);
+
+    cfgitems_snapshot_end_update();
+
+    for (e = txn->entries; e < end; ++e) {
+        cfgitems_string_retire(e->string);
+        if ((e + 1 == end) || (e[1].cfgitem != e->cfgitem))
+            cfgitems_notify(e->cfgitem);
+    }
 
     return CFGITEMS_SUCCESS;
 }
@@ -0,0 +1,263 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_bind.c
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <cfgitems_seqlock.h>
+#include <cfgitems_bind.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static int cfgitems_bind(const char* module, const char* name, enum cfgitems_type type,
+    void* target, size_t size);
+static void cfgitems_bind_store(const struct cfgitems* cfgitem, const struct cfgitems_binding* binding);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+/* lists of bindings of all the entries of the items section, NULL until the first binding */
+static struct cfgitems_binding** cfgitems_bindings = NULL;
+
+/* serializes binders, writers of the items never take it */
+static pthread_mutex_t cfgitems_bind_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * Values set by updates always fit (see cfgitems_bind_string()),
+ * only a longer default value can be cut.
+ */
+static inline void cfgitems_bind_copy(char* target, size_t size, const char* str)
+{
+    size_t len = str ? strnlen(str, size - 1) : 0;
+
+    if (len > 0)
+        memcpy(target, str, len);
+    target[len] = '\0';
+}
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+int cfgitems_bind_bool(const char* module, const char* name, bool* target)
+{
+    return cfgitems_bind(module, name, CFGITEMS_TYPE_BOOL, target, 0);
+}
+
+int cfgitems_bind_string(const char* module, const char* name, char* target, size_t size)
+{
+    /* any value of the item fits */
+    if (size < CFGITEMS_STRING_MAX)
+        return CFGITEMS_FAILURE;
+
+    return cfgitems_bind(module, name, CFGITEMS_TYPE_STRING, target, size);
+}
+
+int cfgitems_bind_double(const char* module, const char* name, double* target)
+{
+    return cfgitems_bind(module, name, CFGITEMS_TYPE_DOUBLE, target, 0);
+}
+
+int cfgitems_bind_s8(const char* module, const char* name, int8_t* target)
+{
+    return cfgitems_bind(module, name, CFGITEMS_TYPE_S8, target, 0);
+}
+
+int cfgitems_bind_u8(const char* module, const char* name, uint8_t* target)
+{
+    return cfgitems_bind(module, name, CFGITEMS_TYPE_U8, target, 0);
+}
+
+int cfgitems_bind_s16(const char* module, const char* name, int16_t* target)
+{
+    return cfgitems_bind(module, name, CFGITEMS_TYPE_S16, target, 0);
+}
+
+int cfgitems_bind_u16(const char* module, const char* name, uint16_t* target)
+{
+    return cfgitems_bind(module, name, CFGITEMS_TYPE_U16, target, 0);
+}
+
+int cfgitems_bind_s32(const char* module, const char* name, int32_t* target)
+{
+    return cfgitems_bind(module, name, CFGITEMS_TYPE_S32, target, 0);
+}
+
+int cfgitems_bind_u32(const char* module, const char* name, uint32_t* target)
+{
+    return cfgitems_bind(module, name, CFGITEMS_TYPE_U32, target, 0);
+}
+
+int cfgitems_bind_s64(const char* module, const char* name, int64_t* target)
+{
+    return cfgitems_bind(module, name, CFGITEMS_TYPE_S64, target, 0);
+}
+
+int cfgitems_bind_u64(const char* module, const char* name, uint64_t* target)
+{
+    return cfgitems_bind(module, name, CFGITEMS_TYPE_U64, target, 0);
+}
+
+void cfgitems_bind_update(const struct cfgitems* cfgitem)
+{
+    struct cfgitems_binding** bindings = __atomic_load_n(&cfgitems_bindings, __ATOMIC_ACQUIRE);
+    struct cfgitems_binding* binding;
+
+    /* nothing has been bound yet */
+    if (bindings == NULL)
+        return;
+
+    binding = __atomic_load_n(&bindings[cfgitem - &CFGITEMS_SECTION_START], __ATOMIC_ACQUIRE);
+
+    for (; binding; binding = binding->next)
+        cfgitems_bind_store(cfgitem, binding);
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+static int cfgitems_bind(const char* module, const char* name, enum cfgitems_type type,
+    void* target, size_t size)
+{
+    struct cfgitems* const cfgitems_start_addr = &CFGITEMS_SECTION_START;
+    struct cfgitems* const cfgitems_end_addr = &CFGITEMS_SECTION_END;
+    struct cfgitems_binding** bindings;
+    struct cfgitems_binding* binding;
+    cfgitems_handle_t handle;
+    size_t i;
+
+    if (target == NULL)
+        return CFGITEMS_FAILURE;
+
+    if (cfgitems_lookup(module, name, type, &handle) != CFGITEMS_SUCCESS)
+        return CFGITEMS_FAILURE;
+
+    /* the item will never change, so it is enough to assign the variable once */
+    if (__atomic_load_n(&cfgitems_frozen, __ATOMIC_RELAXED)) {
+        struct cfgitems_binding once = { NULL, target, size };
+        cfgitems_bind_store(handle, &once);
+        return CFGITEMS_SUCCESS;
+    }
+
+    binding = malloc(sizeof(struct cfgitems_binding));
+    if (binding == NULL)
+        return CFGITEMS_FAILURE;
+
+    binding->target = target;
+    binding->size = size;
+
+    pthread_mutex_lock(&cfgitems_bind_mutex);
+
+    bindings = cfgitems_bindings;
+    if (bindings == NULL) {
+        bindings = calloc(cfgitems_end_addr - cfgitems_start_addr, sizeof(struct cfgitems_binding*));
+        if (bindings == NULL) {
+            pthread_mutex_unlock(&cfgitems_bind_mutex);
+            free(binding);
+            return CFGITEMS_FAILURE;
+        }
+        __atomic_store_n(&cfgitems_bindings, bindings, __ATOMIC_RELEASE);
+    }
+
+    i = handle - cfgitems_start_addr;
+
+    /* writers of the item are kept out, so the variable cannot miss any update */
+    cfgitems_write_begin(handle);
+    binding->next = bindings[i];
+    __atomic_store_n(&bindings[i], binding, __ATOMIC_RELEASE);
+    cfgitems_bind_store(handle, binding);
+    cfgitems_write_end(handle);
+
+    pthread_mutex_unlock(&cfgitems_bind_mutex);
+
+    return CFGITEMS_SUCCESS;
+}
+
+/*
+ * Stores the value of the item with relaxed atomic store, so that
+ * it is never torn for the readers of the variable. Strings are copied
+ * into the buffer of the binding, as the string of the item may be freed
+ * once it has been replaced (see cfgitems_reclaim()).
+ */
+static void cfgitems_bind_store(const struct cfgitems* cfgitem, const struct cfgitems_binding* binding)
+{
+    void* target = binding->target;
+
+    switch (cfgitem->type) {
+        case CFGITEMS_TYPE_BOOL:
+            __atomic_store_n((bool*)target, cfgitem->value->_BOOL_, __ATOMIC_RELAXED);
+            break;
+
+        case CFGITEMS_TYPE_STRING:
+            cfgitems_bind_copy((char*)target, binding->size, cfgitem->value->_STRING_);
+            break;
+
+        case CFGITEMS_TYPE_DOUBLE:
+            __atomic_store((double*)target, &cfgitem->value->_DOUBLE_, __ATOMIC_RELAXED);
+            break;
+
+        case CFGITEMS_TYPE_S8:
+            __atomic_store_n((int8_t*)target, cfgitem->value->_S8_, __ATOMIC_RELAXED);
+            break;
+
+        case CFGITEMS_TYPE_U8:
+            __atomic_store_n((uint8_t*)target, cfgitem->value->_U8_, __ATOMIC_RELAXED);
+            break;
+
+        case CFGITEMS_TYPE_S16:
+            __atomic_store_n((int16_t*)target, cfgitem->value->_S16_, __ATOMIC_RELAXED);
+            break;
+
+        case CFGITEMS_TYPE_U16:
+            __atomic_store_n((uint16_t*)target, cfgitem->value->_U16_, __ATOMIC_RELAXED);
+            break;
+
+        case CFGITEMS_TYPE_S32:
+            __atomic_store_n((int32_t*)target, cfgitem->value->_S32_, __ATOMIC_RELAXED);
+            break;
+
+        case CFGITEMS_TYPE_U32:
+            __atomic_store_n((uint32_t*)target, cfgitem->value->_U32_, __ATOMIC_RELAXED);
+            break;
+
+        case CFGITEMS_TYPE_S64:
+            __atomic_store_n((int64_t*)target, cfgitem->value->_S64_, __ATOMIC_RELAXED);
+            break;
+
+        case CFGITEMS_TYPE_U64:
+            __atomic_store_n((uint64_t*)target, cfgitem->value->_U64_, __ATOMIC_RELAXED);
+            break;
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,124 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_cache.c
+ *
+ * Each thread has a cache of its own (see cfgitems_cache.h), but counts
+ * its hits and misses in a record linked to the list of all the records,
+ * so that any thread (e.g. a monitoring one) can sum them up. Records
+ * of exited threads keep their counts and are reused by new threads.
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <cfgitems_cache.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static void cfgitems_cache_record_put(void* arg);
+static void cfgitems_cache_record_key_create(void);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+static struct cfgitems_cache_record* cfgitems_cache_records = NULL;
+
+static pthread_once_t cfgitems_cache_record_once = PTHREAD_ONCE_INIT;
+static pthread_key_t cfgitems_cache_record_key;
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+struct cfgitems_cache_record* cfgitems_cache_record(void)
+{
+    struct cfgitems_cache_record* record;
+
+    if (pthread_once(&cfgitems_cache_record_once, cfgitems_cache_record_key_create) != 0)
+        return NULL;
+
+    /* reuse a record of an exited thread, if there is one */
+    for (record = __atomic_load_n(&cfgitems_cache_records, __ATOMIC_ACQUIRE); record; record = record->next) {
+        int inactive = 0;
+        if (__atomic_compare_exchange_n(&record->active, &inactive, 1,
+                false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            break;
+    }
+
+    if (record == NULL) {
+        record = aligned_alloc(64, sizeof(struct cfgitems_cache_record));
+        if (record == NULL)
+            return NULL;
+
+        memset(record, 0, sizeof(*record));
+        record->active = 1;
+
+        record->next = __atomic_load_n(&cfgitems_cache_records, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&cfgitems_cache_records, &record->next, record,
+                true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            ;
+    }
+
+    pthread_setspecific(cfgitems_cache_record_key, record);
+
+    return record;
+}
+
+void cfgitems_cache_stats(struct cfgitems_cache_stats* stats)
+{
+    stats->hits = 0;
+    stats->misses = 0;
+
+    for (struct cfgitems_cache_record* record = __atomic_load_n(&cfgitems_cache_records, __ATOMIC_ACQUIRE);
+            record; record = record->next) {
+        stats->hits += __atomic_load_n(&record->hits, __ATOMIC_RELAXED);
+        stats->misses += __atomic_load_n(&record->misses, __ATOMIC_RELAXED);
+    }
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * Called at the exit of the thread.
+ */
+static void cfgitems_cache_record_put(void* arg)
+{
+    struct cfgitems_cache_record* record = arg;
+
+    __atomic_store_n(&record->active, 0, __ATOMIC_RELEASE);
+}
+
+static void cfgitems_cache_record_key_create(void)
+{
+    pthread_key_create(&cfgitems_cache_record_key, cfgitems_cache_record_put);
+}
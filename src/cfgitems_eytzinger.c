@@ -0,0 +1,154 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_eytzinger.c
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems_eytzinger.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+/* slots per cache line; slot k * B is the first of the descendants of slot k three levels below */
+#define CFGITEMS_EYTZINGER_BLOCK (64 / sizeof(struct cfgitems_hash_slot))
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static int cfgitems_eytzinger_compare(const void* l, const void* r);
+static size_t cfgitems_eytzinger_fill(struct cfgitems_hash_slot* table, size_t n,
+    const struct cfgitems_hash_slot* sorted, size_t i, size_t k);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * Next slot in the in-order traversal of the implicit tree (0 if there is none).
+ */
+static inline size_t cfgitems_eytzinger_next(size_t k, size_t n)
+{
+    if (2 * k + 1 <= n) {
+        k = 2 * k + 1;
+        while (2 * k <= n)
+            k = 2 * k;
+    }
+    else
+        k >>= __builtin_ffsll(~(long long)k);
+
+    return k;
+}
+
+/*
+ * First slot (in the in-order traversal) with the hash not less than
+ * the given one (0 if there is none).
+ */
+static inline size_t cfgitems_eytzinger_lower_bound(const struct cfgitems_hash_slot* table,
+    size_t n, uint32_t hash)
+{
+    size_t k = 1;
+
+    /* branchless descent, each step prefetches the descendants three levels below */
+    while (k <= n) {
+        __builtin_prefetch((const char*)table + k * CFGITEMS_EYTZINGER_BLOCK * sizeof(*table));
+        k = 2 * k + (table[k].hash < hash);
+    }
+
+    /* lower bound: undo the right turns taken after the last left one */
+    return k >> __builtin_ffsll(~(long long)k);
+}
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+void cfgitems_eytzinger_build(struct cfgitems_hash_slot* table,
+    struct cfgitems_hash_slot* entries, size_t n)
+{
+    qsort(entries, n, sizeof(struct cfgitems_hash_slot), cfgitems_eytzinger_compare);
+
+    table[0].hash = 0;
+    table[0].id = 0;
+
+    cfgitems_eytzinger_fill(table, n, entries, 0, 1);
+}
+
+struct cfgitems* cfgitems_eytzinger_find(const struct cfgitems_hash_slot* table, size_t size,
+    struct cfgitems* items, uint32_t hash, const char* module, const char* name)
+{
+    size_t n = size ? size - 1 : 0;
+    size_t k;
+
+    for (k = cfgitems_eytzinger_lower_bound(table, n, hash);
+            (k != 0) && (table[k].hash == hash); k = cfgitems_eytzinger_next(k, n)) {
+        struct cfgitems* cfgitem = &items[table[k].id - 1];
+        if (!strcmp(cfgitem->name, name) && !strcmp(cfgitem->module, module))
+            return cfgitem;
+    }
+
+    return NULL;
+}
+
+struct cfgitems* cfgitems_eytzinger_find_span(const struct cfgitems_hash_slot* table, size_t size,
+    struct cfgitems* items, uint32_t hash, const char* module, const char* name, size_t name_len)
+{
+    size_t n = size ? size - 1 : 0;
+    size_t k;
+
+    for (k = cfgitems_eytzinger_lower_bound(table, n, hash);
+            (k != 0) && (table[k].hash == hash); k = cfgitems_eytzinger_next(k, n)) {
+        struct cfgitems* cfgitem = &items[table[k].id - 1];
+        if (cfgitems_span_equals(cfgitem->name, name, name_len) && !strcmp(cfgitem->module, module))
+            return cfgitem;
+    }
+
+    return NULL;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+static int cfgitems_eytzinger_compare(const void* l, const void* r)
+{
+    const struct cfgitems_hash_slot* ls = l;
+    const struct cfgitems_hash_slot* rs = r;
+
+    if (ls->hash != rs->hash)
+        return ls->hash < rs->hash ? -1 : +1;
+
+    return ls->id < rs->id ? -1 : ls->id > rs->id;
+}
+
+static size_t cfgitems_eytzinger_fill(struct cfgitems_hash_slot* table, size_t n,
+    const struct cfgitems_hash_slot* sorted, size_t i, size_t k)
+{
+    if (k <= n) {
+        i = cfgitems_eytzinger_fill(table, n, sorted, i, 2 * k);
+        table[k] = sorted[i++];
+        i = cfgitems_eytzinger_fill(table, n, sorted, i, 2 * k + 1);
+    }
+
+    return i;
+}
@@ -0,0 +1,106 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_hash.c
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems_hash.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+void cfgitems_hash_insert(struct cfgitems_hash_slot* table, size_t size,
+    uint32_t hash, size_t id)
+{
+    size_t i = cfgitems_hash_slot(hash, size);
+
+    while (table[i].id != 0)
+        if (++i == size)
+            i = 0;
+
+    table[i].hash = hash;
+    table[i].id = (uint32_t)(id + 1);
+}
+
+struct cfgitems* cfgitems_hash_find(const struct cfgitems_hash_slot* table, size_t size,
+    struct cfgitems* items, uint32_t hash, const char* module, const char* name)
+{
+    size_t i;
+
+    if (size == 0)
+        return NULL;
+
+    for (i = cfgitems_hash_slot(hash, size); table[i].id != 0; ) {
+        if (table[i].hash == hash) {
+            struct cfgitems* cfgitem = &items[table[i].id - 1];
+            if (!strcmp(cfgitem->name, name) && !strcmp(cfgitem->module, module))
+                return cfgitem;
+        }
+
+        if (++i == size)
+            i = 0;
+    }
+
+    return NULL;
+}
+
+struct cfgitems* cfgitems_hash_find_span(const struct cfgitems_hash_slot* table, size_t size,
+    struct cfgitems* items, uint32_t hash, const char* module, const char* name, size_t name_len)
+{
+    size_t i;
+
+    if (size == 0)
+        return NULL;
+
+    for (i = cfgitems_hash_slot(hash, size); table[i].id != 0; ) {
+        if (table[i].hash == hash) {
+            struct cfgitems* cfgitem = &items[table[i].id - 1];
+            if (cfgitems_span_equals(cfgitem->name, name, name_len) && !strcmp(cfgitem->module, module))
+                return cfgitem;
+        }
+
+        if (++i == size)
+            i = 0;
+    }
+
+    return NULL;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
@@ -0,0 +1,72 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_module.c
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems_module.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+const struct cfgitems_module* cfgitems_module_find(const struct cfgitems_hash_slot* table,
+    size_t size, const struct cfgitems_module* modules, const struct cfgitems* items,
+    const uint32_t* order, uint32_t hash, const char* module, size_t module_len)
+{
+    size_t i;
+
+    if (size == 0)
+        return NULL;
+
+    for (i = cfgitems_hash_slot(hash, size); table[i].id != 0; ) {
+        if (table[i].hash == hash) {
+            const struct cfgitems_module* m = &modules[table[i].id - 1];
+            if (cfgitems_span_equals(items[order[m->first]].module, module, module_len))
+                return m;
+        }
+
+        if (++i == size)
+            i = 0;
+    }
+
+    return NULL;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
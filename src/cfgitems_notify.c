@@ -0,0 +1,360 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_notify.c
+ *
+ * Changed items are queued by the setters (and the parser) in a lock-free
+ * multiple producers, single consumer queue (Vyukov's intrusive one)
+ * and the subscribers are notified by a dispatcher thread, so the setters
+ * never wait for them. The dispatcher thread is started by the very
+ * first subscription, until then nothing is queued at all.
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <cfgitems_notify.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+struct cfgitems_subscription
+{
+    struct cfgitems_subscription* next;
+    char* module;
+    char* name; /* NULL for all the items of the module */
+    cfgitems_notify_callback_t callback;
+    void* ctx;
+};
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static int cfgitems_notify_start(void);
+static void cfgitems_notify_push(struct cfgitems_notify_node* node);
+static struct cfgitems_notify_node* cfgitems_notify_pop(void);
+static void* cfgitems_dispatcher(void* arg);
+static int cfgitems_subscription_check(cfgitems_handle_t handle, void* arg);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+/* nodes of all the entries of the items section, NULL until the first subscription */
+static struct cfgitems_notify_node* cfgitems_notify_nodes = NULL;
+
+static struct cfgitems_notify_node cfgitems_notify_stub;
+
+/* producers push at the head, the dispatcher pops from the tail */
+static struct cfgitems_notify_node* cfgitems_notify_head = &cfgitems_notify_stub;
+static struct cfgitems_notify_node* cfgitems_notify_tail = &cfgitems_notify_stub;
+
+/* posted for each queued item, the dispatcher sleeps on it */
+static sem_t cfgitems_notify_sem;
+
+/* items queued and dispatched so far (see cfgitems_flush_notifications()) */
+static uint64_t cfgitems_notify_queued = 0;
+static uint64_t cfgitems_notify_dispatched = 0;
+
+/* guards the subscriptions and cfgitems_notify_dispatched, setters never take it */
+static pthread_mutex_t cfgitems_notify_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cfgitems_notify_cond = PTHREAD_COND_INITIALIZER;
+
+static struct cfgitems_subscription* cfgitems_subscriptions = NULL;
+
+static pthread_t cfgitems_dispatcher_thread;
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+static inline bool cfgitems_subscription_matches(const struct cfgitems_subscription* s,
+    const struct cfgitems* cfgitem)
+{
+    return !strcmp(s->module, cfgitem->module) && ((s->name == NULL) || !strcmp(s->name, cfgitem->name));
+}
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+int cfgitems_subscribe(const char* module, const char* name, cfgitems_notify_callback_t callback,
+    void* ctx)
+{
+    struct cfgitems_subscription* s;
+    bool wildcard;
+    int status;
+
+    if ((name == NULL) || (callback == NULL))
+        return CFGITEMS_FAILURE;
+
+    if (module == NULL)
+        module = CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE);
+
+    /* item names never contain the wildcard, so it is just a check of the module then */
+    wildcard = !strcmp(name, CFGITEMS_NOTIFY_WILDCARD);
+    status = cfgitems_foreach_in_module(module, cfgitems_subscription_check, (void*)name);
+    if (status != (wildcard ? CFGITEMS_SUCCESS : 1))
+        return CFGITEMS_FAILURE;
+
+    s = calloc(1, sizeof(struct cfgitems_subscription));
+    if (s == NULL)
+        return CFGITEMS_FAILURE;
+
+    s->module = strdup(module);
+    s->name = wildcard ? NULL : strdup(name);
+    s->callback = callback;
+    s->ctx = ctx;
+    if ((s->module == NULL) || (!wildcard && (s->name == NULL))) {
+        free(s->module);
+        free(s->name);
+        free(s);
+        return CFGITEMS_FAILURE;
+    }
+
+    pthread_mutex_lock(&cfgitems_notify_mutex);
+
+    status = cfgitems_notify_start();
+    if (status == CFGITEMS_SUCCESS) {
+        s->next = cfgitems_subscriptions;
+        cfgitems_subscriptions = s;
+    }
+
+    pthread_mutex_unlock(&cfgitems_notify_mutex);
+
+    if (status != CFGITEMS_SUCCESS) {
+        free(s->module);
+        free(s->name);
+        free(s);
+    }
+
+    return status;
+}
+
+int cfgitems_unsubscribe(const char* module, const char* name, cfgitems_notify_callback_t callback,
+    void* ctx)
+{
+    struct cfgitems_subscription** link;
+    struct cfgitems_subscription* s = NULL;
+
+    if (name == NULL)
+        return CFGITEMS_FAILURE;
+
+    if (module == NULL)
+        module = CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE);
+
+    if (!strcmp(name, CFGITEMS_NOTIFY_WILDCARD))
+        name = NULL;
+
+    pthread_mutex_lock(&cfgitems_notify_mutex);
+
+    for (link = &cfgitems_subscriptions; *link != NULL; link = &(*link)->next) {
+        s = *link;
+        if ((s->callback == callback) && (s->ctx == ctx) && !strcmp(s->module, module) &&
+            (name ? (s->name && !strcmp(s->name, name)) : (s->name == NULL))) {
+            *link = s->next;
+            break;
+        }
+        s = NULL;
+    }
+
+    pthread_mutex_unlock(&cfgitems_notify_mutex);
+
+    if (s == NULL)
+        return CFGITEMS_FAILURE;
+
+    free(s->module);
+    free(s->name);
+    free(s);
+
+    return CFGITEMS_SUCCESS;
+}
+
+int cfgitems_flush_notifications(void)
+{
+    uint64_t queued = __atomic_load_n(&cfgitems_notify_queued, __ATOMIC_ACQUIRE);
+
+    if (__atomic_load_n(&cfgitems_notify_nodes, __ATOMIC_ACQUIRE) == NULL)
+        return CFGITEMS_SUCCESS;
+
+    /* the dispatcher would wait for itself */
+    if (pthread_equal(pthread_self(), cfgitems_dispatcher_thread))
+        return CFGITEMS_FAILURE;
+
+    pthread_mutex_lock(&cfgitems_notify_mutex);
+
+    while (cfgitems_notify_dispatched < queued)
+        pthread_cond_wait(&cfgitems_notify_cond, &cfgitems_notify_mutex);
+
+    pthread_mutex_unlock(&cfgitems_notify_mutex);
+
+    return CFGITEMS_SUCCESS;
+}
+
+void cfgitems_notify(struct cfgitems* cfgitem)
+{
+    struct cfgitems_notify_node* nodes = __atomic_load_n(&cfgitems_notify_nodes, __ATOMIC_ACQUIRE);
+    struct cfgitems_notify_node* node;
+
+    /* nobody has subscribed yet */
+    if (nodes == NULL)
+        return;
+
+    node = &nodes[cfgitem - &CFGITEMS_SECTION_START];
+
+    /* still queued, the change will be reported together with the previous one(s) */
+    if (__atomic_exchange_n(&node->queued, 1, __ATOMIC_ACQ_REL))
+        return;
+
+    __atomic_add_fetch(&cfgitems_notify_queued, 1, __ATOMIC_RELEASE);
+
+    cfgitems_notify_push(node);
+
+    sem_post(&cfgitems_notify_sem);
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * Allocates the nodes and starts the dispatcher thread, unless it is
+ * already running. Has to be called with cfgitems_notify_mutex locked.
+ */
+static int cfgitems_notify_start(void)
+{
+    struct cfgitems* const cfgitems_start_addr = &CFGITEMS_SECTION_START;
+    struct cfgitems* const cfgitems_end_addr = &CFGITEMS_SECTION_END;
+    struct cfgitems_notify_node* nodes;
+    pthread_attr_t attr;
+    int status;
+
+    if (cfgitems_notify_nodes != NULL)
+        return CFGITEMS_SUCCESS;
+
+    nodes = calloc(cfgitems_end_addr - cfgitems_start_addr, sizeof(struct cfgitems_notify_node));
+    if (nodes == NULL)
+        return CFGITEMS_FAILURE;
+
+    if (sem_init(&cfgitems_notify_sem, 0, 0) != 0) {
+        free(nodes);
+        return CFGITEMS_FAILURE;
+    }
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    status = pthread_create(&cfgitems_dispatcher_thread, &attr, cfgitems_dispatcher, NULL);
+    pthread_attr_destroy(&attr);
+
+    if (status != 0) {
+        sem_destroy(&cfgitems_notify_sem);
+        free(nodes);
+        return CFGITEMS_FAILURE;
+    }
+
+    /* from now on the setters queue the changed items */
+    __atomic_store_n(&cfgitems_notify_nodes, nodes, __ATOMIC_RELEASE);
+
+    return CFGITEMS_SUCCESS;
+}
+
+static void cfgitems_notify_push(struct cfgitems_notify_node* node)
+{
+    struct cfgitems_notify_node* prev;
+
+    __atomic_store_n(&node->next, NULL, __ATOMIC_RELAXED);
+    prev = __atomic_exchange_n(&cfgitems_notify_head, node, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+}
+
+/*
+ * Pops the oldest node. May return NULL also when a producer is just
+ * pushing one, it posts the semaphore only once the node is linked though,
+ * so the dispatcher will look again.
+ */
+static struct cfgitems_notify_node* cfgitems_notify_pop(void)
+{
+    struct cfgitems_notify_node* tail = cfgitems_notify_tail;
+    struct cfgitems_notify_node* next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+
+    if (tail == &cfgitems_notify_stub) {
+        if (next == NULL)
+            return NULL;
+        cfgitems_notify_tail = tail = next;
+        next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+    }
+
+    if (next != NULL) {
+        cfgitems_notify_tail = next;
+        return tail;
+    }
+
+    if (tail != __atomic_load_n(&cfgitems_notify_head, __ATOMIC_ACQUIRE))
+        return NULL;
+
+    /* the last node can be popped only with another one behind it */
+    cfgitems_notify_push(&cfgitems_notify_stub);
+
+    next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+    if (next != NULL) {
+        cfgitems_notify_tail = next;
+        return tail;
+    }
+
+    return NULL;
+}
+
+static void* cfgitems_dispatcher(void* arg)
+{
+    (void)arg;
+
+    for (;;) {
+        struct cfgitems_notify_node* node;
+
+        while (sem_wait(&cfgitems_notify_sem) != 0)
+            if (errno != EINTR)
+                return NULL;
+
+        while ((node = cfgitems_notify_pop()) != NULL) {
+            struct cfgitems* cfgitem = &CFGITEMS_SECTION_START + (node - cfgitems_notify_nodes);
+
+            /* changes made from now on queue the item again */
+            __atomic_exchange_n(&node->queued, 0, __ATOMIC_ACQ_REL);
+
+            pthread_mutex_lock(&cfgitems_notify_mutex);
+
+            for (struct cfgitems_subscription* s = cfgitems_subscriptions; s; s = s->next)
+                if (cfgitems_subscription_matches(s, cfgitem))
+                    s->callback(cfgitem, s->ctx);
+
+            cfgitems_notify_dispatched++;
+            pthread_cond_broadcast(&cfgitems_notify_cond);
+
+            pthread_mutex_unlock(&cfgitems_notify_mutex);
+        }
+    }
+
+    return NULL;
+}
+
+static int cfgitems_subscription_check(cfgitems_handle_t handle, void* arg)
+{
+    return strcmp(handle->name, arg) ? CFGITEMS_SUCCESS : 1;
+}
@@ -0,0 +1,324 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_reload.c
+ *
+ * The configuration file is watched with inotify by a thread of its own.
+ * Both the file and its directory are watched, the directory one catches
+ * new files renamed over the watched one (the way editors and deployment
+ * tools replace files atomically), the file one catches changes made
+ * through symbolic links. Events are debounced: the file is reloaded only
+ * once it has not changed for the given period, so a burst of writes
+ * results in a single reload. Reloads write only the items whose values
+ * have changed (see cfgitems_parse_changes()), readers never wait for them.
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <cfgitems_reload.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+/* events of the directory which (when they concern the file) trigger a reload */
+#define CFGITEMS_RELOAD_DIR_EVENTS (IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE)
+
+/* events of the file itself which trigger a reload */
+#define CFGITEMS_RELOAD_FILE_EVENTS (IN_CLOSE_WRITE | IN_MODIFY)
+
+/* size of the buffer inotify events are read into */
+#define CFGITEMS_RELOAD_BUFFER_SIZE 4096
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static void cfgitems_reload_watch_file(void);
+static bool cfgitems_reload_read_events(void);
+static int64_t cfgitems_reload_now(void);
+static void* cfgitems_reload_watcher(void* arg);
+static void cfgitems_reload_release(void);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+/* guards starting and stopping of the watcher */
+static pthread_mutex_t cfgitems_reload_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static bool cfgitems_reload_running = false;
+static pthread_t cfgitems_reload_thread;
+
+static char* cfgitems_reload_path = NULL;
+static char* cfgitems_reload_dir = NULL;
+static const char* cfgitems_reload_name = NULL; /* last component of the path */
+
+static int cfgitems_reload_debounce = 0; /* milliseconds */
+
+static int cfgitems_reload_inotify = -1;
+static int cfgitems_reload_dir_wd = -1;
+static int cfgitems_reload_file_wd = -1;
+
+/* written by cfgitems_reload_stop() to wake the watcher up */
+static int cfgitems_reload_pipe[2] = { -1, -1 };
+
+/* reloads done so far (see cfgitems_reloads()) */
+static uint64_t cfgitems_reload_count = 0;
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+int cfgitems_reload_start(const char* filename, unsigned debounce_ms)
+{
+    const char* slash;
+    int retval = CFGITEMS_FAILURE;
+
+    if (filename == NULL)
+        return CFGITEMS_FAILURE;
+
+    slash = strrchr(filename, '/');
+    if ((slash ? slash[1] : filename[0]) == '\0')
+        return CFGITEMS_FAILURE;
+
+    pthread_mutex_lock(&cfgitems_reload_mutex);
+
+    if (cfgitems_reload_running) {
+        pthread_mutex_unlock(&cfgitems_reload_mutex);
+        return CFGITEMS_FAILURE;
+    }
+
+    do {
+        cfgitems_reload_path = strdup(filename);
+        if (slash == NULL)
+            cfgitems_reload_dir = strdup(".");
+        else
+        if (slash == filename)
+            cfgitems_reload_dir = strdup("/");
+        else
+            cfgitems_reload_dir = strndup(filename, slash - filename);
+
+        if ((cfgitems_reload_path == NULL) || (cfgitems_reload_dir == NULL))
+            break;
+
+        cfgitems_reload_name = cfgitems_reload_path + (slash ? slash + 1 - filename : 0);
+        cfgitems_reload_debounce = debounce_ms > INT_MAX ? INT_MAX : (int)debounce_ms;
+
+        cfgitems_reload_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (cfgitems_reload_inotify < 0)
+            break;
+
+        if (pipe(cfgitems_reload_pipe) != 0)
+            break;
+
+        fcntl(cfgitems_reload_pipe[0], F_SETFD, FD_CLOEXEC);
+        fcntl(cfgitems_reload_pipe[1], F_SETFD, FD_CLOEXEC);
+
+        /* the file itself may not exist yet, but its directory has to */
+        cfgitems_reload_dir_wd = inotify_add_watch(cfgitems_reload_inotify, cfgitems_reload_dir,
+            CFGITEMS_RELOAD_DIR_EVENTS | IN_ONLYDIR);
+        if (cfgitems_reload_dir_wd < 0)
+            break;
+
+        cfgitems_reload_watch_file();
+
+        if (pthread_create(&cfgitems_reload_thread, NULL, cfgitems_reload_watcher, NULL) != 0)
+            break;
+
+        cfgitems_reload_running = true;
+        retval = CFGITEMS_SUCCESS;
+    } while (0);
+
+    if (retval != CFGITEMS_SUCCESS)
+        cfgitems_reload_release();
+
+    pthread_mutex_unlock(&cfgitems_reload_mutex);
+
+    return retval;
+}
+
+int cfgitems_reload_stop(void)
+{
+    int retval = CFGITEMS_FAILURE;
+
+    pthread_mutex_lock(&cfgitems_reload_mutex);
+
+    if (cfgitems_reload_running) {
+        while ((write(cfgitems_reload_pipe[1], "", 1) < 0) && (errno == EINTR))
+            ;
+        pthread_join(cfgitems_reload_thread, NULL);
+        cfgitems_reload_release();
+        cfgitems_reload_running = false;
+        retval = CFGITEMS_SUCCESS;
+    }
+
+    pthread_mutex_unlock(&cfgitems_reload_mutex);
+
+    return retval;
+}
+
+uint64_t cfgitems_reloads(void)
+{
+    return __atomic_load_n(&cfgitems_reload_count, __ATOMIC_ACQUIRE);
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * (Re)watches the file found at the path now. Once the file has been
+ * replaced, the watch of the previous one is not needed any more.
+ */
+static void cfgitems_reload_watch_file(void)
+{
+    int wd = inotify_add_watch(cfgitems_reload_inotify, cfgitems_reload_path,
+        CFGITEMS_RELOAD_FILE_EVENTS);
+
+    if ((cfgitems_reload_file_wd >= 0) && (cfgitems_reload_file_wd != wd))
+        inotify_rm_watch(cfgitems_reload_inotify, cfgitems_reload_file_wd);
+
+    cfgitems_reload_file_wd = wd;
+}
+
+/*
+ * Reads all the pending events.
+ *
+ * @return true if any of them concerns the configuration file.
+ */
+static bool cfgitems_reload_read_events(void)
+{
+    char buf[CFGITEMS_RELOAD_BUFFER_SIZE]
+        __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool changed = false;
+    ssize_t n;
+
+    while ((n = read(cfgitems_reload_inotify, buf, sizeof(buf))) > 0)
+        for (char* p = buf; p < buf + n; ) {
+            const struct inotify_event* event = (const struct inotify_event*)p;
+
+            if (event->mask & IN_Q_OVERFLOW)
+                changed = true; /* events have been lost, the file may have changed */
+            else
+            if ((event->wd == cfgitems_reload_file_wd) && (event->mask & CFGITEMS_RELOAD_FILE_EVENTS))
+                changed = true;
+            else
+            if ((event->wd == cfgitems_reload_dir_wd) && (event->mask & CFGITEMS_RELOAD_DIR_EVENTS) &&
+                (event->len > 0) && !strcmp(event->name, cfgitems_reload_name))
+                changed = true;
+
+            p += sizeof(struct inotify_event) + event->len;
+        }
+
+    return changed;
+}
+
+static int64_t cfgitems_reload_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void* cfgitems_reload_watcher(void* arg)
+{
+    struct pollfd fds[2];
+    int64_t deadline = -1; /* no reload is pending */
+
+    (void)arg;
+
+    fds[0].fd = cfgitems_reload_inotify;
+    fds[0].events = POLLIN;
+    fds[1].fd = cfgitems_reload_pipe[0];
+    fds[1].events = POLLIN;
+
+    for (;;) {
+        int timeout = -1;
+        int n;
+
+        /*
+         * Wait only for what is left until the deadline, events of other
+         * files in the directory must not postpone a pending reload.
+         */
+        if (deadline >= 0) {
+            int64_t left = deadline - cfgitems_reload_now();
+            timeout = (left > 0) ? (int)left : 0;
+        }
+
+        n = poll(fds, 2, timeout);
+
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        if (fds[1].revents)
+            break; /* cfgitems_reload_stop() */
+
+        /* each change of the file postpones the reload again */
+        if ((n > 0) && cfgitems_reload_read_events())
+            deadline = cfgitems_reload_now() + cfgitems_reload_debounce;
+
+        if ((deadline >= 0) && (cfgitems_reload_now() >= deadline)) {
+            /* nothing has changed for the debounce period, the writer is done */
+            cfgitems_reload_watch_file();
+            cfgitems_parse_changes(cfgitems_reload_path);
+            __atomic_add_fetch(&cfgitems_reload_count, 1, __ATOMIC_RELEASE);
+            deadline = -1;
+        }
+    }
+
+    return NULL;
+}
+
+static void cfgitems_reload_release(void)
+{
+    if (cfgitems_reload_inotify >= 0)
+        close(cfgitems_reload_inotify);
+
+    for (int i = 0; i < 2; ++i)
+        if (cfgitems_reload_pipe[i] >= 0)
+            close(cfgitems_reload_pipe[i]);
+
+    free(cfgitems_reload_path);
+    free(cfgitems_reload_dir);
+
+    cfgitems_reload_path = NULL;
+    cfgitems_reload_dir = NULL;
+    cfgitems_reload_name = NULL;
+    cfgitems_reload_inotify = -1;
+    cfgitems_reload_dir_wd = -1;
+    cfgitems_reload_file_wd = -1;
+    cfgitems_reload_pipe[0] = cfgitems_reload_pipe[1] = -1;
+}
@@ -0,0 +1,425 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_scan.c
+ *
+ * Tokenizer of configuration files. Each line is scanned with four
+ * searches: for its end ('\n' or '\0'), past its leading whitespace
+ * characters, for the end of a token (any of "\t =", or the end
+ * of the line) and past the delimiters between tokens. None of them
+ * ever crosses the end of the line, so the whole buffer is scanned
+ * in linear time. SSE2 and AVX2 implementations of the searches
+ * compare 16 and 32 characters at a time, the scalar ones are used
+ * for the remaining few characters at the end of the buffer
+ * (vectors are never loaded beyond it) and on other architectures.
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CFGITEMS_SCAN_X86
+#endif
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems_scan.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+/*
+ * Defines tokenizer cfgitems_scan_<isa>() on top of the searches
+ * cfgitems_scan_<search>_<isa>(), compiled for the instruction set.
+ */
+#define CFGITEMS_SCAN_DEFINE(_isa_, _target_)                                                       \
+    static _target_ size_t cfgitems_scan_ ## _isa_(struct cfgitems_scanner* scanner,                \
+        struct cfgitems_token* tokens, size_t n)                                                    \
+    {                                                                                               \
+        const char* const end = scanner->end;                                                       \
+        const char* next = scanner->next;                                                           \
+        size_t k = 0;                                                                               \
+                                                                                                    \
+        while ((k < n) && (next < end)) {                                                           \
+            const char* line;                                                                       \
+            const char* eol;                                                                        \
+            const char* name;                                                                       \
+            const char* value;                                                                      \
+                                                                                                    \
+            eol = cfgitems_scan_find_eol_ ## _isa_(next, end);                                      \
+            line = cfgitems_scan_skip_spaces_ ## _isa_(next, end);                                  \
+            next = cfgitems_scan_next_line(eol, end);                                               \
+                                                                                                    \
+            /* ignore comments and empty lines */                                                   \
+            if ((line == eol) || (*line == ';') || (*line == '#'))                                  \
+                continue;                                                                           \
+                                                                                                    \
+            /* remove trailing whitespace characters */                                             \
+            while (cfgitems_scan_is_space(eol[-1]))                                                 \
+                eol--;                                                                              \
+                                                                                                    \
+            if (*line == '[') { /* section definition line */                                       \
+                if ((eol - line >= 2) && (eol[-1] == ']')) {                                        \
+                    tokens[k].type = CFGITEMS_TOKEN_SECTION;                                        \
+                    tokens[k].name = line + 1;                                                      \
+                    tokens[k].name_len = eol - line - 2;                                            \
+                    tokens[k].value = eol;                                                          \
+                    tokens[k].value_len = 0;                                                        \
+                    k++;                                                                            \
+                }                                                                                   \
+                continue;                                                                           \
+            }                                                                                       \
+                                                                                                    \
+            /* searches may end within the trailing whitespace characters */                        \
+            name = cfgitems_scan_skip_delimiters_ ## _isa_(line, end);                              \
+            if (name >= eol)                                                                        \
+                continue;                                                                           \
+                                                                                                    \
+            tokens[k].type = CFGITEMS_TOKEN_ITEM;                                                   \
+            tokens[k].name = name;                                                                  \
+            value = cfgitems_scan_min(cfgitems_scan_find_delimiter_ ## _isa_(name, end), eol);      \
+            tokens[k].name_len = value - name;                                                      \
+            value = cfgitems_scan_min(cfgitems_scan_skip_delimiters_ ## _isa_(value, end), eol);    \
+            tokens[k].value = value;                                                                \
+            tokens[k].value_len =                                                                   \
+                cfgitems_scan_min(cfgitems_scan_find_delimiter_ ## _isa_(value, end), eol) - value; \
+            k++;                                                                                    \
+        }                                                                                           \
+                                                                                                    \
+        scanner->next = next;                                                                       \
+                                                                                                    \
+        return k;                                                                                   \
+    }
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static cfgitems_scan_t cfgitems_scan_select(void);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+static cfgitems_scan_t cfgitems_scan_best = NULL;
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/* isspace() of "C" locale, but the newline, which is never within a line */
+static inline bool cfgitems_scan_is_space(char c)
+{
+    return (c == ' ') || (c == '\t') || (c == '\v') || (c == '\f') || (c == '\r');
+}
+
+static inline bool cfgitems_scan_is_delimiter(char c)
+{
+    return (c == ' ') || (c == '\t') || (c == '=');
+}
+
+static inline bool cfgitems_scan_is_eol(char c)
+{
+    return (c == '\n') || (c == '\0');
+}
+
+static inline const char* cfgitems_scan_min(const char* l, const char* r)
+{
+    return (l < r) ? l : r;
+}
+
+/*
+ * Beginning of the line following the one ending at 'eol'. A null character
+ * cuts the line short, but the rest of it still has to be skipped.
+ */
+static inline const char* cfgitems_scan_next_line(const char* eol, const char* end)
+{
+    if ((eol < end) && (*eol == '\0')) {
+        eol = memchr(eol, '\n', end - eol);
+        if (eol == NULL)
+            return end;
+    }
+
+    return (eol < end) ? eol + 1 : end;
+}
+
+/*
+ * Scalar searches. 'end' is the end of the buffer, but none of them goes
+ * beyond the end of the line: neither '\n' nor '\0' is a whitespace
+ * character or a delimiter, and the end of a token is found at the end
+ * of the line at the latest.
+ */
+static inline const char* cfgitems_scan_find_eol_scalar(const char* p, const char* end)
+{
+    while ((p < end) && !cfgitems_scan_is_eol(*p))
+        p++;
+
+    return p;
+}
+
+static inline const char* cfgitems_scan_skip_spaces_scalar(const char* p, const char* end)
+{
+    while ((p < end) && cfgitems_scan_is_space(*p))
+        p++;
+
+    return p;
+}
+
+static inline const char* cfgitems_scan_find_delimiter_scalar(const char* p, const char* end)
+{
+    while ((p < end) && !cfgitems_scan_is_delimiter(*p) && !cfgitems_scan_is_eol(*p))
+        p++;
+
+    return p;
+}
+
+static inline const char* cfgitems_scan_skip_delimiters_scalar(const char* p, const char* end)
+{
+    while ((p < end) && cfgitems_scan_is_delimiter(*p))
+        p++;
+
+    return p;
+}
+
+#if defined(CFGITEMS_SCAN_X86)
+/*
+ * SSE2 searches. Bit i of a mask is set when the i-th character
+ * of the vector belongs to the class.
+ */
+__attribute__((target("sse2")))
+static inline uint32_t cfgitems_scan_eols_sse2(__m128i v)
+{
+    return _mm_movemask_epi8(_mm_or_si128(
+        _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+        _mm_cmpeq_epi8(v, _mm_setzero_si128())));
+}
+
+__attribute__((target("sse2")))
+static inline uint32_t cfgitems_scan_spaces_sse2(__m128i v)
+{
+    /* '\t', '\v', '\f' and '\r' are 9, 11, 12 and 13 */
+    __m128i c = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+    __m128i s = _mm_cmpeq_epi8(_mm_min_epu8(c, _mm_set1_epi8(4)), c);
+
+    s = _mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), s);
+
+    return _mm_movemask_epi8(_mm_or_si128(s, _mm_cmpeq_epi8(v, _mm_set1_epi8(' '))));
+}
+
+__attribute__((target("sse2")))
+static inline uint32_t cfgitems_scan_delimiters_sse2(__m128i v)
+{
+    return _mm_movemask_epi8(_mm_or_si128(
+        _mm_or_si128(
+            _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+            _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+        _mm_cmpeq_epi8(v, _mm_set1_epi8('='))));
+}
+
+__attribute__((target("sse2")))
+static inline const char* cfgitems_scan_find_eol_sse2(const char* p, const char* end)
+{
+    for (; end - p >= 16; p += 16) {
+        uint32_t mask = cfgitems_scan_eols_sse2(_mm_loadu_si128((const __m128i*)p));
+        if (mask)
+            return p + __builtin_ctz(mask);
+    }
+
+    return cfgitems_scan_find_eol_scalar(p, end);
+}
+
+__attribute__((target("sse2")))
+static inline const char* cfgitems_scan_skip_spaces_sse2(const char* p, const char* end)
+{
+    for (; end - p >= 16; p += 16) {
+        uint32_t mask = ~cfgitems_scan_spaces_sse2(_mm_loadu_si128((const __m128i*)p)) & 0xffff;
+        if (mask)
+            return p + __builtin_ctz(mask);
+    }
+
+    return cfgitems_scan_skip_spaces_scalar(p, end);
+}
+
+__attribute__((target("sse2")))
+static inline const char* cfgitems_scan_find_delimiter_sse2(const char* p, const char* end)
+{
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        uint32_t mask = cfgitems_scan_delimiters_sse2(v) | cfgitems_scan_eols_sse2(v);
+        if (mask)
+            return p + __builtin_ctz(mask);
+    }
+
+    return cfgitems_scan_find_delimiter_scalar(p, end);
+}
+
+__attribute__((target("sse2")))
+static inline const char* cfgitems_scan_skip_delimiters_sse2(const char* p, const char* end)
+{
+    for (; end - p >= 16; p += 16) {
+        uint32_t mask = ~cfgitems_scan_delimiters_sse2(_mm_loadu_si128((const __m128i*)p)) & 0xffff;
+        if (mask)
+            return p + __builtin_ctz(mask);
+    }
+
+    return cfgitems_scan_skip_delimiters_scalar(p, end);
+}
+
+/*
+ * AVX2 searches, the very same as SSE2 ones, but 32 characters at a time.
+ */
+__attribute__((target("avx2")))
+static inline uint32_t cfgitems_scan_eols_avx2(__m256i v)
+{
+    return _mm256_movemask_epi8(_mm256_or_si256(
+        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+        _mm256_cmpeq_epi8(v, _mm256_setzero_si256())));
+}
+
+__attribute__((target("avx2")))
+static inline uint32_t cfgitems_scan_spaces_avx2(__m256i v)
+{
+    __m256i c = _mm256_sub_epi8(v, _mm256_set1_epi8('\t'));
+    __m256i s = _mm256_cmpeq_epi8(_mm256_min_epu8(c, _mm256_set1_epi8(4)), c);
+
+    s = _mm256_andnot_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')), s);
+
+    return _mm256_movemask_epi8(_mm256_or_si256(s, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '))));
+}
+
+__attribute__((target("avx2")))
+static inline uint32_t cfgitems_scan_delimiters_avx2(__m256i v)
+{
+    return _mm256_movemask_epi8(_mm256_or_si256(
+        _mm256_or_si256(
+            _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('='))));
+}
+
+__attribute__((target("avx2")))
+static inline const char* cfgitems_scan_find_eol_avx2(const char* p, const char* end)
+{
+    for (; end - p >= 32; p += 32) {
+        uint32_t mask = cfgitems_scan_eols_avx2(_mm256_loadu_si256((const __m256i*)p));
+        if (mask)
+            return p + __builtin_ctz(mask);
+    }
+
+    return cfgitems_scan_find_eol_scalar(p, end);
+}
+
+__attribute__((target("avx2")))
+static inline const char* cfgitems_scan_skip_spaces_avx2(const char* p, const char* end)
+{
+    for (; end - p >= 32; p += 32) {
+        uint32_t mask = ~cfgitems_scan_spaces_avx2(_mm256_loadu_si256((const __m256i*)p));
+        if (mask)
+            return p + __builtin_ctz(mask);
+    }
+
+    return cfgitems_scan_skip_spaces_scalar(p, end);
+}
+
+__attribute__((target("avx2")))
+static inline const char* cfgitems_scan_find_delimiter_avx2(const char* p, const char* end)
+{
+    for (; end - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        uint32_t mask = cfgitems_scan_delimiters_avx2(v) | cfgitems_scan_eols_avx2(v);
+        if (mask)
+            return p + __builtin_ctz(mask);
+    }
+
+    return cfgitems_scan_find_delimiter_scalar(p, end);
+}
+
+__attribute__((target("avx2")))
+static inline const char* cfgitems_scan_skip_delimiters_avx2(const char* p, const char* end)
+{
+    for (; end - p >= 32; p += 32) {
+        uint32_t mask = ~cfgitems_scan_delimiters_avx2(_mm256_loadu_si256((const __m256i*)p));
+        if (mask)
+            return p + __builtin_ctz(mask);
+    }
+
+    return cfgitems_scan_skip_delimiters_scalar(p, end);
+}
+#endif /* CFGITEMS_SCAN_X86 */
+
+CFGITEMS_SCAN_DEFINE(scalar, )
+
+#if defined(CFGITEMS_SCAN_X86)
+CFGITEMS_SCAN_DEFINE(sse2, __attribute__((target("sse2"))))
+CFGITEMS_SCAN_DEFINE(avx2, __attribute__((target("avx2"))))
+#endif
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+size_t cfgitems_scan(struct cfgitems_scanner* scanner, struct cfgitems_token* tokens, size_t n)
+{
+    cfgitems_scan_t scan = __atomic_load_n(&cfgitems_scan_best, __ATOMIC_RELAXED);
+
+    if (scan == NULL) {
+        scan = cfgitems_scan_select();
+        __atomic_store_n(&cfgitems_scan_best, scan, __ATOMIC_RELAXED);
+    }
+
+    return scan(scanner, tokens, n);
+}
+
+cfgitems_scan_t cfgitems_scan_get(enum cfgitems_scan_isa isa)
+{
+#if defined(CFGITEMS_SCAN_X86)
+    __builtin_cpu_init();
+#endif
+
+    switch (isa) {
+        case CFGITEMS_SCAN_SCALAR:
+            return cfgitems_scan_scalar;
+
+#if defined(CFGITEMS_SCAN_X86)
+        case CFGITEMS_SCAN_SSE2:
+            return __builtin_cpu_supports("sse2") ? cfgitems_scan_sse2 : NULL;
+
+        case CFGITEMS_SCAN_AVX2:
+            return __builtin_cpu_supports("avx2") ? cfgitems_scan_avx2 : NULL;
+#endif
+
+        default:
+            return NULL;
+    }
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+static cfgitems_scan_t cfgitems_scan_select(void)
+{
+    static const enum cfgitems_scan_isa preferred[] = {
+        CFGITEMS_SCAN_AVX2,
+        CFGITEMS_SCAN_SSE2,
+    };
+
+    for (size_t i = 0; i < sizeof(preferred) / sizeof(preferred[0]); ++i) {
+        cfgitems_scan_t scan = cfgitems_scan_get(preferred[i]);
+        if (scan != NULL)
+            return scan;
+    }
+
+    return cfgitems_scan_scalar;
+}
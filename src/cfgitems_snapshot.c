@@ -0,0 +1,539 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_snapshot.c
+ *
+ * Snapshots are reclaimed with hazard pointers. Each thread owns a record
+ * with CFGITEMS_SNAPSHOT_SLOTS slots, in which it announces the snapshots
+ * it holds. Acquiring a snapshot writes only to the thread's own record,
+ * so readers on different cores do not share any cache line written
+ * by them. Writers only count their changes (see cfgitems_snapshot_touch()),
+ * the first reader acquiring a snapshot after a change takes a new one,
+ * publishes it by swapping the pointer to the current one and frees
+ * the old ones once no slot refers to them. Thus a snapshot is taken
+ * at most once per acquire, however many items have been set since.
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <cfgitems_seqlock.h>
+#include <cfgitems_snapshot.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+/* copies of the values made while items are being set, before the last one is given up */
+#define CFGITEMS_SNAPSHOT_ATTEMPTS 4
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+/*
+ * Hazard pointers of a thread. Records are never freed, those of exited
+ * threads are reused by the new ones.
+ */
+struct cfgitems_reader
+{
+    struct cfgitems_snapshot* slots[CFGITEMS_SNAPSHOT_SLOTS];
+    struct cfgitems_reader* next;
+    int active;
+} __attribute__((aligned(64)));
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+uint64_t cfgitems_snapshot_stamp = 0;
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static struct cfgitems_reader* cfgitems_reader_get(void);
+static void cfgitems_reader_put(void* arg);
+static void cfgitems_reader_key_create(void);
+static struct cfgitems_snapshot* cfgitems_snapshot_create(void);
+static void cfgitems_snapshot_copy(struct cfgitems_snapshot* snapshot);
+static int cfgitems_snapshot_refresh(void);
+static int cfgitems_snapshot_swap(void);
+static bool cfgitems_snapshot_held(const struct cfgitems_snapshot* snapshot);
+static void cfgitems_snapshot_reclaim(void);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+static struct cfgitems_snapshot* cfgitems_snapshot_current = NULL;
+
+/* snapshots replaced by newer ones, but possibly still held by some threads */
+static struct cfgitems_snapshot* cfgitems_snapshot_retired = NULL;
+
+/* serializes updates of many items and taking of snapshots, setters never take it */
+static pthread_mutex_t cfgitems_snapshot_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static struct cfgitems_reader* cfgitems_readers = NULL;
+
+static pthread_once_t cfgitems_reader_once = PTHREAD_ONCE_INIT;
+static pthread_key_t cfgitems_reader_key;
+
+static __thread struct cfgitems_reader* cfgitems_reader = NULL;
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+static inline const struct cfgitems* cfgitems_snapshot_item(const struct cfgitems_snapshot* snapshot,
+    cfgitems_handle_t handle)
+{
+    size_t i;
+
+    if ((snapshot == NULL) || (handle == NULL))
+        return NULL;
+
+    i = handle - &CFGITEMS_SECTION_START;
+
+    return i < snapshot->n_entries ? handle : NULL;
+}
+
+#define CFGITEMS_SNAPSHOT_VALUE(snapshot, handle) \
+    ((snapshot)->values[(handle) - &CFGITEMS_SECTION_START])
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+const struct cfgitems_snapshot* cfgitems_snapshot_acquire(void)
+{
+    struct cfgitems_reader* reader;
+    struct cfgitems_snapshot* snapshot;
+    bool refreshed = false;
+    size_t slot;
+
+    reader = cfgitems_reader_get();
+    if (reader == NULL)
+        return NULL;
+
+    for (slot = 0; slot < CFGITEMS_SNAPSHOT_SLOTS; ++slot)
+        if (reader->slots[slot] == NULL)
+            break;
+
+    if (slot == CFGITEMS_SNAPSHOT_SLOTS)
+        return NULL; /* the thread holds too many snapshots */
+
+    for (;;) {
+        snapshot = __atomic_load_n(&cfgitems_snapshot_current, __ATOMIC_ACQUIRE);
+
+        if (snapshot != NULL) {
+            /* announce the snapshot and make sure it has not been retired meanwhile */
+            for (;;) {
+                struct cfgitems_snapshot* current;
+
+                __atomic_store_n(&reader->slots[slot], snapshot, __ATOMIC_SEQ_CST);
+
+                current = __atomic_load_n(&cfgitems_snapshot_current, __ATOMIC_SEQ_CST);
+                if (current == snapshot)
+                    break;
+
+                snapshot = current;
+            }
+
+            /* a snapshot which could not be refreshed is still consistent, just older */
+            if (refreshed || (snapshot->stamp == __atomic_load_n(&cfgitems_snapshot_stamp, __ATOMIC_ACQUIRE)))
+                return snapshot;
+        }
+        else
+        if (refreshed)
+            return NULL;
+
+        /* the values have changed since the current snapshot has been taken */
+        cfgitems_snapshot_refresh();
+        refreshed = true;
+    }
+}
+
+void cfgitems_snapshot_release(const struct cfgitems_snapshot* snapshot)
+{
+    struct cfgitems_reader* reader = cfgitems_reader;
+
+    if ((snapshot == NULL) || (reader == NULL))
+        return;
+
+    for (size_t slot = 0; slot < CFGITEMS_SNAPSHOT_SLOTS; ++slot)
+        if (reader->slots[slot] == snapshot) {
+            __atomic_store_n(&reader->slots[slot], NULL, __ATOMIC_RELEASE);
+            break;
+        }
+}
+
+uint64_t cfgitems_snapshot_version(const struct cfgitems_snapshot* snapshot)
+{
+    return snapshot ? snapshot->version : 0;
+}
+
+void cfgitems_snapshot_begin_update(void)
+{
+    pthread_mutex_lock(&cfgitems_snapshot_mutex);
+}
+
+void cfgitems_snapshot_end_update(void)
+{
+    cfgitems_snapshot_touch();
+
+    pthread_mutex_unlock(&cfgitems_snapshot_mutex);
+}
+
+int cfgitems_snapshot_get_bool(const struct cfgitems_snapshot* snapshot, cfgitems_handle_t handle,
+    bool* value)
+{
+    if (cfgitems_snapshot_item(snapshot, handle) == NULL)
+        return CFGITEMS_FAILURE;
+
+    if (value)
+        *value = CFGITEMS_SNAPSHOT_VALUE(snapshot, handle)._BOOL_;
+
+    return CFGITEMS_SUCCESS;
+}
+
+int cfgitems_snapshot_get_string(const struct cfgitems_snapshot* snapshot, cfgitems_handle_t handle,
+    const char** value)
+{
+    if (cfgitems_snapshot_item(snapshot, handle) == NULL)
+        return CFGITEMS_FAILURE;
+
+    if (value)
+        *value = CFGITEMS_SNAPSHOT_VALUE(snapshot, handle)._STRING_;
+
+    return CFGITEMS_SUCCESS;
+}
+
+int cfgitems_snapshot_get_double(const struct cfgitems_snapshot* snapshot, cfgitems_handle_t handle,
+    double* value)
+{
+    if (cfgitems_snapshot_item(snapshot, handle) == NULL)
+        return CFGITEMS_FAILURE;
+
+    if (value)
+        *value = CFGITEMS_SNAPSHOT_VALUE(snapshot, handle)._DOUBLE_;
+
+    return CFGITEMS_SUCCESS;
+}
+
+int cfgitems_snapshot_get_s8(const struct cfgitems_snapshot* snapshot, cfgitems_handle_t handle,
+    int8_t* value)
+{
+    if (cfgitems_snapshot_item(snapshot, handle) == NULL)
+        return CFGITEMS_FAILURE;
+
+    if (value)
+        *value = CFGITEMS_SNAPSHOT_VALUE(snapshot, handle)._S8_;
+
+    return CFGITEMS_SUCCESS;
+}
+
+int cfgitems_snapshot_get_u8(const struct cfgitems_snapshot* snapshot, cfgitems_handle_t handle,
+    uint8_t* value)
+{
+    if (cfgitems_snapshot_item(snapshot, handle) == NULL)
+        return CFGITEMS_FAILURE;
+
+    if (value)
+        *value = CFGITEMS_SNAPSHOT_VALUE(snapshot, handle)._U8_;
+
+    return CFGITEMS_SUCCESS;
+}
+
+int cfgitems_snapshot_get_s16(const struct cfgitems_snapshot* snapshot, cfgitems_handle_t handle,
+    int16_t* value)
+{
+    if (cfgitems_snapshot_item(snapshot, handle) == NULL)
+        return CFGITEMS_FAILURE;
+
+    if (value)
+        *value = CFGITEMS_SNAPSHOT_VALUE(snapshot, handle)._S16_;
+
+    return CFGITEMS_SUCCESS;
+}
+
+int cfgitems_snapshot_get_u16(const struct cfgitems_snapshot* snapshot, cfgitems_handle_t handle,
+    uint16_t* value)
+{
+    if (cfgitems_snapshot_item(snapshot, handle) == NULL)
+        return CFGITEMS_FAILURE;
+
+    if (value)
+        *value = CFGITEMS_SNAPSHOT_VALUE(snapshot, handle)._U16_;
+
+    return CFGITEMS_SUCCESS;
+}
+
+int cfgitems_snapshot_get_s32(const struct cfgitems_snapshot* snapshot, cfgitems_handle_t handle,
+    int32_t* value)
+{
+    if (cfgitems_snapshot_item(snapshot, handle) == NULL)
+        return CFGITEMS_FAILURE;
+
+    if (value)
+        *value = CFGITEMS_SNAPSHOT_VALUE(snapshot, handle)._S32_;
+
+    return CFGITEMS_SUCCESS;
+}
+
+int cfgitems_snapshot_get_u32(const struct cfgitems_snapshot* snapshot, cfgitems_handle_t handle,
+    uint32_t* value)
+{
+    if (cfgitems_snapshot_item(snapshot, handle) == NULL)
+        return CFGITEMS_FAILURE;
+
+    if (value)
+        *value = CFGITEMS_SNAPSHOT_VALUE(snapshot, handle)._U32_;
+
+    return CFGITEMS_SUCCESS;
+}
+
+int cfgitems_snapshot_get_s64(const struct cfgitems_snapshot* snapshot, cfgitems_handle_t handle,
+    int64_t* value)
+{
+    if (cfgitems_snapshot_item(snapshot, handle) == NULL)
+        return CFGITEMS_FAILURE;
+
+    if (value)
+        *value = CFGITEMS_SNAPSHOT_VALUE(snapshot, handle)._S64_;
+
+    return CFGITEMS_SUCCESS;
+}
+
+int cfgitems_snapshot_get_u64(const struct cfgitems_snapshot* snapshot, cfgitems_handle_t handle,
+    uint64_t* value)
+{
+    if (cfgitems_snapshot_item(snapshot, handle) == NULL)
+        return CFGITEMS_FAILURE;
+
+    if (value)
+        *value = CFGITEMS_SNAPSHOT_VALUE(snapshot, handle)._U64_;
+
+    return CFGITEMS_SUCCESS;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+static struct cfgitems_reader* cfgitems_reader_get(void)
+{
+    struct cfgitems_reader* reader = cfgitems_reader;
+
+    if (reader != NULL)
+        return reader;
+
+    if (pthread_once(&cfgitems_reader_once, cfgitems_reader_key_create) != 0)
+        return NULL;
+
+    /* reuse a record of an exited thread, if there is one */
+    for (reader = __atomic_load_n(&cfgitems_readers, __ATOMIC_ACQUIRE); reader; reader = reader->next) {
+        int inactive = 0;
+        if (__atomic_compare_exchange_n(&reader->active, &inactive, 1,
+                false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            break;
+    }
+
+    if (reader == NULL) {
+        reader = aligned_alloc(64, sizeof(struct cfgitems_reader));
+        if (reader == NULL)
+            return NULL;
+
+        memset(reader, 0, sizeof(*reader));
+        reader->active = 1;
+
+        reader->next = __atomic_load_n(&cfgitems_readers, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&cfgitems_readers, &reader->next, reader,
+                true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            ;
+    }
+
+    pthread_setspecific(cfgitems_reader_key, reader);
+    cfgitems_reader = reader;
+
+    return reader;
+}
+
+/*
+ * Called at the exit of the thread. Snapshots the thread has not released
+ * are released now.
+ */
+static void cfgitems_reader_put(void* arg)
+{
+    struct cfgitems_reader* reader = arg;
+
+    for (size_t slot = 0; slot < CFGITEMS_SNAPSHOT_SLOTS; ++slot)
+        __atomic_store_n(&reader->slots[slot], NULL, __ATOMIC_RELEASE);
+
+    __atomic_store_n(&reader->active, 0, __ATOMIC_RELEASE);
+}
+
+static void cfgitems_reader_key_create(void)
+{
+    pthread_key_create(&cfgitems_reader_key, cfgitems_reader_put);
+}
+
+static struct cfgitems_snapshot* cfgitems_snapshot_create(void)
+{
+    struct cfgitems* const cfgitems_start_addr = &CFGITEMS_SECTION_START;
+    struct cfgitems* const cfgitems_end_addr = &CFGITEMS_SECTION_END;
+    size_t n_entries = cfgitems_end_addr - cfgitems_start_addr;
+    size_t n_strings = 0;
+    struct cfgitems_snapshot* snapshot;
+
+    for (size_t i = 0; i < n_entries; ++i)
+        if ((cfgitems_start_addr[i].module != NULL) &&
+            (cfgitems_start_addr[i].type == CFGITEMS_TYPE_STRING))
+            n_strings++;
+
+    snapshot = malloc(sizeof(struct cfgitems_snapshot) +
+        n_entries * sizeof(union cfgitems_any) + n_strings * CFGITEMS_STRING_MAX);
+    if (snapshot == NULL)
+        return NULL;
+
+    snapshot->version = 0;
+    snapshot->stamp = 0;
+    snapshot->retired = NULL;
+    snapshot->n_entries = n_entries;
+    snapshot->strings = (char*)&snapshot->values[n_entries];
+
+    return snapshot;
+}
+
+static void cfgitems_snapshot_copy(struct cfgitems_snapshot* snapshot)
+{
+    struct cfgitems* const cfgitems_start_addr = &CFGITEMS_SECTION_START;
+    char* strings = snapshot->strings;
+
+    /* replaced strings are not freed while they are being copied */
+    cfgitems_read_lock();
+
+    for (size_t i = 0; i < snapshot->n_entries; ++i) {
+        struct cfgitems* it = &cfgitems_start_addr[i];
+        uint32_t seq;
+
+        if (it->module == NULL) {
+            memset(&snapshot->values[i], 0, sizeof(union cfgitems_any));
+            continue;
+        }
+
+        do {
+            seq = cfgitems_read_begin(it);
+            snapshot->values[i] = *it->value;
+            if ((it->type == CFGITEMS_TYPE_STRING) && (it->string != NULL)) {
+                /* string set by an update will be freed once replaced by the next one */
+                strcpy(strings, snapshot->values[i]._STRING_);
+                snapshot->values[i]._STRING_ = strings;
+            }
+        } while (cfgitems_read_retry(it, seq));
+
+        if (it->type == CFGITEMS_TYPE_STRING)
+            strings += CFGITEMS_STRING_MAX;
+    }
+
+    cfgitems_read_unlock();
+}
+
+static int cfgitems_snapshot_refresh(void)
+{
+    int retval;
+
+    pthread_mutex_lock(&cfgitems_snapshot_mutex);
+    retval = cfgitems_snapshot_swap();
+    pthread_mutex_unlock(&cfgitems_snapshot_mutex);
+
+    return retval;
+}
+
+/*
+ * Replaces the current snapshot with a new one (unless another reader
+ * has done so meanwhile) and retires the old one. The values are copied
+ * again when any item has been set while they were being copied,
+ * as the copy could mix values set before and after the changed ones.
+ * Has to be called with cfgitems_snapshot_mutex locked.
+ */
+static int cfgitems_snapshot_swap(void)
+{
+    struct cfgitems_snapshot* snapshot = NULL;
+    struct cfgitems_snapshot* old;
+
+    old = cfgitems_snapshot_current;
+
+    for (int attempt = 0; ; ++attempt) {
+        uint64_t stamp = __atomic_load_n(&cfgitems_snapshot_stamp, __ATOMIC_ACQUIRE);
+
+        if ((old != NULL) && (old->stamp == stamp)) {
+            free(snapshot);
+            return CFGITEMS_SUCCESS;
+        }
+
+        /* keep the current one, there is no quiet moment to take a new one */
+        if ((old != NULL) && (attempt == CFGITEMS_SNAPSHOT_ATTEMPTS)) {
+            free(snapshot);
+            return CFGITEMS_FAILURE;
+        }
+
+        if ((snapshot == NULL) && ((snapshot = cfgitems_snapshot_create()) == NULL))
+            return CFGITEMS_FAILURE;
+
+        cfgitems_snapshot_copy(snapshot);
+
+        if (__atomic_load_n(&cfgitems_snapshot_stamp, __ATOMIC_ACQUIRE) == stamp) {
+            snapshot->stamp = stamp;
+            break;
+        }
+    }
+
+    snapshot->version = old ? old->version + 1 : 1;
+
+    __atomic_store_n(&cfgitems_snapshot_current, snapshot, __ATOMIC_SEQ_CST);
+
+    if (old != NULL) {
+        old->retired = cfgitems_snapshot_retired;
+        cfgitems_snapshot_retired = old;
+    }
+
+    cfgitems_snapshot_reclaim();
+
+    return CFGITEMS_SUCCESS;
+}
+
+static bool cfgitems_snapshot_held(const struct cfgitems_snapshot* snapshot)
+{
+    for (struct cfgitems_reader* reader = __atomic_load_n(&cfgitems_readers, __ATOMIC_ACQUIRE);
+            reader; reader = reader->next)
+        for (size_t slot = 0; slot < CFGITEMS_SNAPSHOT_SLOTS; ++slot)
+            if (__atomic_load_n(&reader->slots[slot], __ATOMIC_SEQ_CST) == snapshot)
+                return true;
+
+    return false;
+}
+
+/*
+ * Frees the retired snapshots no thread holds. Has to be called
+ * with cfgitems_snapshot_mutex locked.
+ */
+static void cfgitems_snapshot_reclaim(void)
+{
+    struct cfgitems_snapshot** link = &cfgitems_snapshot_retired;
+
+    while (*link != NULL) {
+        struct cfgitems_snapshot* snapshot = *link;
+
+        if (cfgitems_snapshot_held(snapshot)) {
+            link = &snapshot->retired;
+            continue;
+        }
+
+        *link = snapshot->retired;
+        free(snapshot);
+    }
+}
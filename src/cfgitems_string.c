@@ -0,0 +1,223 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_string.c
+ *
+ * Values of 'string' items are reclaimed with epochs. Writers publish
+ * a new string, advance the global epoch and tag the replaced string
+ * with the epoch it has been retired in. Each thread owns a record,
+ * in which it announces the epoch it has entered its read side critical
+ * section in (zero when it is outside of any). Retired strings are kept
+ * until the program calls cfgitems_reclaim(), as strings obtained outside
+ * of any section may still be used. It frees those whose epoch is older
+ * than every announced one, as none of those readers could have seen them.
+ * Readers write only to their own records and never wait for writers.
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <cfgitems_string.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+/*
+ * Announced epoch of a thread. Records are never freed, those of exited
+ * threads are reused by the new ones.
+ */
+struct cfgitems_string_reader
+{
+    uint64_t epoch; /* zero outside of the read side critical section */
+    struct cfgitems_string_reader* next;
+    int active;
+} __attribute__((aligned(64)));
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static struct cfgitems_string_reader* cfgitems_string_reader_get(void);
+static void cfgitems_string_reader_put(void* arg);
+static void cfgitems_string_reader_key_create(void);
+static void cfgitems_string_reclaim(void);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+static uint64_t cfgitems_string_epoch = 1;
+
+/* strings replaced by newer ones, but possibly still read by some threads */
+static struct cfgitems_string* cfgitems_string_retired = NULL;
+
+/* serializes writers retiring strings, readers never take it */
+static pthread_mutex_t cfgitems_string_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static struct cfgitems_string_reader* cfgitems_string_readers = NULL;
+
+static pthread_once_t cfgitems_string_reader_once = PTHREAD_ONCE_INIT;
+static pthread_key_t cfgitems_string_reader_key;
+
+static __thread struct cfgitems_string_reader* cfgitems_string_reader = NULL;
+static __thread unsigned cfgitems_string_nesting = 0;
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+void cfgitems_read_lock(void)
+{
+    struct cfgitems_string_reader* reader;
+
+    if (cfgitems_string_nesting++)
+        return;
+
+    reader = cfgitems_string_reader_get();
+    if (reader == NULL)
+        return;
+
+    /* announced before any string of the section is read */
+    __atomic_store_n(&reader->epoch, __atomic_load_n(&cfgitems_string_epoch, __ATOMIC_ACQUIRE),
+        __ATOMIC_SEQ_CST);
+}
+
+void cfgitems_read_unlock(void)
+{
+    struct cfgitems_string_reader* reader = cfgitems_string_reader;
+
+    if ((cfgitems_string_nesting == 0) || --cfgitems_string_nesting)
+        return;
+
+    if (reader != NULL)
+        __atomic_store_n(&reader->epoch, 0, __ATOMIC_RELEASE);
+}
+
+void cfgitems_string_retire(struct cfgitems_string* string)
+{
+    if (string == NULL)
+        return;
+
+    pthread_mutex_lock(&cfgitems_string_mutex);
+
+    /* readers entering from now on cannot see the string any more */
+    string->epoch = __atomic_fetch_add(&cfgitems_string_epoch, 1, __ATOMIC_SEQ_CST);
+    string->retired = cfgitems_string_retired;
+    cfgitems_string_retired = string;
+
+    pthread_mutex_unlock(&cfgitems_string_mutex);
+}
+
+void cfgitems_reclaim(void)
+{
+    pthread_mutex_lock(&cfgitems_string_mutex);
+    cfgitems_string_reclaim();
+    pthread_mutex_unlock(&cfgitems_string_mutex);
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+static struct cfgitems_string_reader* cfgitems_string_reader_get(void)
+{
+    struct cfgitems_string_reader* reader = cfgitems_string_reader;
+
+    if (reader != NULL)
+        return reader;
+
+    if (pthread_once(&cfgitems_string_reader_once, cfgitems_string_reader_key_create) != 0)
+        return NULL;
+
+    /* reuse a record of an exited thread, if there is one */
+    for (reader = __atomic_load_n(&cfgitems_string_readers, __ATOMIC_ACQUIRE); reader; reader = reader->next) {
+        int inactive = 0;
+        if (__atomic_compare_exchange_n(&reader->active, &inactive, 1,
+                false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            break;
+    }
+
+    if (reader == NULL) {
+        reader = aligned_alloc(64, sizeof(struct cfgitems_string_reader));
+        if (reader == NULL)
+            return NULL;
+
+        memset(reader, 0, sizeof(*reader));
+        reader->active = 1;
+
+        reader->next = __atomic_load_n(&cfgitems_string_readers, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&cfgitems_string_readers, &reader->next, reader,
+                true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            ;
+    }
+
+    pthread_setspecific(cfgitems_string_reader_key, reader);
+    cfgitems_string_reader = reader;
+
+    return reader;
+}
+
+/*
+ * Called at the exit of the thread. The section the thread has not ended
+ * is ended now.
+ */
+static void cfgitems_string_reader_put(void* arg)
+{
+    struct cfgitems_string_reader* reader = arg;
+
+    __atomic_store_n(&reader->epoch, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&reader->active, 0, __ATOMIC_RELEASE);
+}
+
+static void cfgitems_string_reader_key_create(void)
+{
+    pthread_key_create(&cfgitems_string_reader_key, cfgitems_string_reader_put);
+}
+
+/*
+ * Frees the retired strings no thread can read any more. Has to be called
+ * with cfgitems_string_mutex locked.
+ */
+static void cfgitems_string_reclaim(void)
+{
+    struct cfgitems_string** link = &cfgitems_string_retired;
+    uint64_t oldest = UINT64_MAX;
+
+    for (struct cfgitems_string_reader* reader = __atomic_load_n(&cfgitems_string_readers, __ATOMIC_ACQUIRE);
+            reader; reader = reader->next) {
+        uint64_t epoch = __atomic_load_n(&reader->epoch, __ATOMIC_SEQ_CST);
+        if ((epoch != 0) && (epoch < oldest))
+            oldest = epoch;
+    }
+
+    while (*link != NULL) {
+        struct cfgitems_string* string = *link;
+
+        if (string->epoch >= oldest) {
+            link = &string->retired;
+            continue;
+        }
+
+        *link = string->retired;
+        free(string);
+    }
+}
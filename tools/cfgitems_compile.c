@@ -0,0 +1,433 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_compile.c
+ *
+ * Tool which compiles configuration (in .ini file format) for the given
+ * executable: values of its configuration items are converted to their
+ * types once, at deployment time, and stored in an image which
+ * cfgitems_load_compiled() applies without any text parsing.
+ *
+ * Values are taken the way cfgitems_parse() takes them: lines of unknown
+ * modules and items, as well as invalid values, are ignored, and the last
+ * valid value of an item wins. The image records the digest of the items
+ * of the executable, it is rejected by any other one.
+ *
+ * The tool has to be built for the same ABI as the executable
+ * (it uses 'struct cfgitems' layout as seen by its own compiler).
+ * Only 64-bit little-endian ELF files are supported.
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <cfgitems_hash.h>
+#include <cfgitems_index.h>
+#include <cfgitems_parse.h>
+#include <cfgitems_scan.h>
+#include <cfgitems_image.h>
+#include <cfgitems_elf.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+/* lines tokenized at once */
+#define COMPILE_TOKENS 64
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+struct item
+{
+    const char* module;
+    const char* name;
+    uint32_t type;
+    uint32_t hash;
+
+    /* the last valid value found in the configuration */
+    bool set;
+    union cfgitems_any any;
+    const char* string;
+    size_t length;
+};
+
+/* key of the looked up item, spans over the configuration */
+struct span_key
+{
+    const char* module;
+    size_t module_len;
+    const char* name;
+    size_t name_len;
+};
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static int read_items(struct elf_file* elf, struct item** items, size_t* n_items);
+static int compare_items(const void* l, const void* r);
+static int compare_span_key(const void* key, const void* item);
+static void take_value(struct item* items, size_t n_items, const struct span_key* key,
+    const char* value, size_t value_len);
+static int read_configuration(const char* path, struct item* items, size_t n_items);
+static int write_image(const char* path, const struct item* items, size_t n_items);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * Compares the span (which never contains null characters)
+ * with the string the way strcmp() does.
+ */
+static inline int compare_span(const char* span, size_t len, const char* str)
+{
+    int status = strncmp(span, str, len);
+
+    return status ? status : -(str[len] != '\0');
+}
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+int main(int argc, char* argv[])
+{
+    struct elf_file elf;
+    struct item* items = NULL;
+    size_t n_items = 0;
+    int status;
+
+    if (argc != 4) {
+        fprintf(stderr, "usage: %s <executable> <configuration> <compiled configuration>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (elf_open(&elf, argv[1], false) != CFGITEMS_SUCCESS)
+        return EXIT_FAILURE;
+
+    status = read_items(&elf, &items, &n_items);
+
+    if (status == CFGITEMS_SUCCESS)
+        status = read_configuration(argv[2], items, n_items);
+
+    if (status == CFGITEMS_SUCCESS)
+        status = write_image(argv[3], items, n_items);
+
+    free(items);
+    elf_close(&elf);
+
+    return status == CFGITEMS_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * Reads keys and types of the items of the executable,
+ * sorted the way cfgitems_init() sorts them.
+ */
+static int read_items(struct elf_file* elf, struct item** items, size_t* n_items)
+{
+    const Elf64_Shdr* section;
+    struct item* k;
+    size_t n_entries;
+    size_t n = 0;
+
+    section = elf_find_section(elf, CFGITEMS_SECTION_NAME);
+    if (section == NULL) {
+        fprintf(stderr, "'%s' has no '%s' section\n", elf->path, CFGITEMS_SECTION_NAME);
+        return CFGITEMS_FAILURE;
+    }
+
+    if ((section->sh_size % sizeof(struct cfgitems)) ||
+        (section->sh_offset + section->sh_size > elf->size)) {
+        fprintf(stderr, "'%s' has malformed '%s' section\n", elf->path, CFGITEMS_SECTION_NAME);
+        return CFGITEMS_FAILURE;
+    }
+
+    if (elf_collect_relocs(elf, section) != CFGITEMS_SUCCESS)
+        return CFGITEMS_FAILURE;
+
+    n_entries = section->sh_size / sizeof(struct cfgitems);
+
+    k = calloc(n_entries ? n_entries : 1, sizeof(struct item));
+    if (k == NULL)
+        return CFGITEMS_FAILURE;
+
+    for (size_t i = 0; i < n_entries; ++i) {
+        size_t offset = i * sizeof(struct cfgitems);
+        uint64_t module = elf_read_pointer(elf, section, offset + offsetof(struct cfgitems, module));
+        uint64_t name = elf_read_pointer(elf, section, offset + offsetof(struct cfgitems, name));
+        enum cfgitems_type type;
+
+        if (module == 0)
+            continue;
+
+        k[n].module = elf_string_at(elf, module);
+        k[n].name = elf_string_at(elf, name);
+        if ((k[n].module == NULL) || (k[n].name == NULL)) {
+            fprintf(stderr, "'%s': cannot resolve key of configuration item #%zu\n", elf->path, i);
+            free(k);
+            return CFGITEMS_FAILURE;
+        }
+
+        memcpy(&type, elf->data + section->sh_offset + offset + offsetof(struct cfgitems, type),
+            sizeof(type));
+        k[n].type = type;
+        k[n].hash = cfgitems_hash_key(k[n].module, k[n].name);
+        n++;
+    }
+
+    qsort(k, n, sizeof(struct item), compare_items);
+
+    for (size_t i = 1; i < n; ++i)
+        if (compare_items(&k[i - 1], &k[i]) == 0) {
+            fprintf(stderr, "'%s': configuration item '%s' in module '%s' is defined more than once\n",
+                elf->path, k[i].name, k[i].module);
+            free(k);
+            return CFGITEMS_FAILURE;
+        }
+
+    *items = k;
+    *n_items = n;
+
+    return CFGITEMS_SUCCESS;
+}
+
+static int compare_items(const void* l, const void* r)
+{
+    const struct item* li = l;
+    const struct item* ri = r;
+
+    return cfgitems_compare_keys(li->module, li->name, ri->module, ri->name);
+}
+
+/*
+ * cfgitems_compare_keys() of the looked up key and the item.
+ */
+static int compare_span_key(const void* key, const void* item)
+{
+    const struct span_key* k = key;
+    const struct item* i = item;
+    bool global;
+    int status;
+
+    status = compare_span(k->module, k->module_len, i->module);
+    if (status) {
+        global = !compare_span(k->module, k->module_len, CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE));
+        if (global)
+            return -1;
+        else
+        if (!strcmp(i->module, CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE)))
+            return +1;
+        else
+            return status;
+    }
+
+    return compare_span(k->name, k->name_len, i->name);
+}
+
+/*
+ * Converts the value of the item (if it is one of ours) the way
+ * cfgitems_parse() does.
+ */
+static void take_value(struct item* items, size_t n_items, const struct span_key* key,
+    const char* value, size_t value_len)
+{
+    struct item* item;
+    union cfgitems_any any;
+
+    item = bsearch(key, items, n_items, sizeof(struct item), compare_span_key);
+    if ((item == NULL) || (value_len == 0))
+        return;
+
+    if (value[0] == '\"')
+        value++, value_len--;
+    if ((value_len > 0) && (value[value_len - 1] == '\"'))
+        value_len--;
+
+    if (item->type == CFGITEMS_TYPE_STRING) {
+        if (value_len < CFGITEMS_STRING_MAX) {
+            item->string = value;
+            item->length = value_len;
+        }
+        else {
+            fprintf(stderr, "warning: invalid value '%.*s' of configuration item '%s' in module '%s' ignored\n",
+                (int)value_len, value, item->name, item->module);
+            return;
+        }
+    }
+    else {
+        /* all 8 bytes of the value end up in the image, keep it reproducible */
+        memset(&any, 0, sizeof(any));
+        if (cfgitems_span_to_any(item->type, value, value_len, &any) == CFGITEMS_SUCCESS)
+            item->any = any;
+        else {
+            fprintf(stderr, "warning: invalid value '%.*s' of configuration item '%s' in module '%s' ignored\n",
+                (int)value_len, value, item->name, item->module);
+            return;
+        }
+    }
+
+    item->set = true;
+}
+
+/*
+ * Values of the items point into the configuration, which stays mapped
+ * until the process exits.
+ */
+static int read_configuration(const char* path, struct item* items, size_t n_items)
+{
+    struct cfgitems_token tokens[COMPILE_TOKENS];
+    struct cfgitems_scanner scanner;
+    struct span_key key;
+    struct stat st;
+    const char* buf = "";
+    size_t n;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "failed to open '%s': %m\n", path);
+        return CFGITEMS_FAILURE;
+    }
+
+    if ((fstat(fd, &st) < 0) || !S_ISREG(st.st_mode)) {
+        fprintf(stderr, "'%s' is not a regular file\n", path);
+        close(fd);
+        return CFGITEMS_FAILURE;
+    }
+
+    if (st.st_size > 0) {
+        buf = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (buf == MAP_FAILED) {
+            fprintf(stderr, "failed to map '%s'\n", path);
+            close(fd);
+            return CFGITEMS_FAILURE;
+        }
+    }
+
+    close(fd);
+
+    /* lines preceding the first section belong to the global module */
+    key.module = CFGITEMS_XSTR(CFGITEMS_GLOBAL_MODULE);
+    key.module_len = strlen(key.module);
+
+    cfgitems_scanner_init(&scanner, buf, st.st_size);
+    while ((n = cfgitems_scan(&scanner, tokens, COMPILE_TOKENS)) > 0)
+        for (size_t i = 0; i < n; ++i) {
+            if (tokens[i].type == CFGITEMS_TOKEN_SECTION) {
+                key.module = tokens[i].name;
+                key.module_len = tokens[i].name_len;
+            }
+            else {
+                key.name = tokens[i].name;
+                key.name_len = tokens[i].name_len;
+                take_value(items, n_items, &key, tokens[i].value, tokens[i].value_len);
+            }
+        }
+
+    return CFGITEMS_SUCCESS;
+}
+
+static int write_image(const char* path, const struct item* items, size_t n_items)
+{
+    struct cfgitems_image_header* header;
+    struct cfgitems_image_value* values;
+    char* strings;
+    size_t n_values = 0;
+    size_t strings_size = 0;
+    size_t size;
+    char* image;
+    FILE* fp;
+    int retval = CFGITEMS_FAILURE;
+
+    for (size_t i = 0; i < n_items; ++i)
+        if (items[i].set) {
+            n_values++;
+            strings_size += items[i].length;
+        }
+
+    if (strings_size > UINT32_MAX) {
+        fprintf(stderr, "values of string items are too long (%zu bytes)\n", strings_size);
+        return CFGITEMS_FAILURE;
+    }
+
+    size = sizeof(*header) + n_values * sizeof(*values) + strings_size;
+    image = calloc(1, size);
+    if (image == NULL)
+        return CFGITEMS_FAILURE;
+
+    header = (struct cfgitems_image_header*)image;
+    values = (struct cfgitems_image_value*)(header + 1);
+    strings = (char*)(values + n_values);
+
+    header->magic = CFGITEMS_IMAGE_MAGIC;
+    header->version = CFGITEMS_IMAGE_VERSION;
+    header->registry = CFGITEMS_IMAGE_VERSION;
+    header->n_values = n_values;
+    header->strings_size = strings_size;
+
+    strings_size = 0;
+    for (size_t i = 0; i < n_items; ++i) {
+        header->registry = cfgitems_image_registry(header->registry, items[i].module,
+            items[i].name, items[i].type);
+
+        if (!items[i].set)
+            continue;
+
+        values->hash = items[i].hash;
+        values->item = i;
+        values->type = items[i].type;
+
+        if (items[i].type == CFGITEMS_TYPE_STRING) {
+            values->length = items[i].length;
+            values->value = strings_size;
+            memcpy(strings + strings_size, items[i].string, items[i].length);
+            strings_size += items[i].length;
+        }
+        else
+            memcpy(&values->value, &items[i].any, sizeof(items[i].any));
+
+        values++;
+    }
+
+    header->checksum = cfgitems_digest(image + sizeof(*header), size - sizeof(*header));
+
+    fp = fopen(path, "wb");
+    if (fp == NULL)
+        fprintf(stderr, "failed to create '%s': %m\n", path);
+    else {
+        if ((fwrite(image, 1, size, fp) == size) && (fflush(fp) == 0))
+            retval = CFGITEMS_SUCCESS;
+        else
+            fprintf(stderr, "failed to write '%s': %m\n", path);
+        fclose(fp);
+    }
+
+    free(image);
+
+    return retval;
+}
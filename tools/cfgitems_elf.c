@@ -0,0 +1,229 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_elf.c
+ *
+ * Executables are mapped as a whole. Writable ones (cfgitems-presort)
+ * are modified in place.
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <cfgitems_elf.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+#if !defined(R_AARCH64_RELATIVE)
+    #define R_AARCH64_RELATIVE 1027
+#endif
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+static inline int compare_relocs(const void* l, const void* r)
+{
+    const Elf64_Rela* lr = *(const Elf64_Rela* const*)l;
+    const Elf64_Rela* rr = *(const Elf64_Rela* const*)r;
+
+    return (lr->r_offset > rr->r_offset) - (lr->r_offset < rr->r_offset);
+}
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+int elf_open(struct elf_file* elf, const char* path, bool writable)
+{
+    struct stat st;
+    int fd;
+
+    memset(elf, 0, sizeof(*elf));
+    elf->path = path;
+    elf->writable = writable;
+
+    fd = open(path, writable ? O_RDWR : O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "failed to open '%s': %m\n", path);
+        return CFGITEMS_FAILURE;
+    }
+
+    if (fstat(fd, &st) < 0) {
+        fprintf(stderr, "failed to stat '%s': %m\n", path);
+        close(fd);
+        return CFGITEMS_FAILURE;
+    }
+
+    elf->size = st.st_size;
+    elf->data = elf->size >= sizeof(Elf64_Ehdr) ?
+        mmap(NULL, elf->size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0) :
+        MAP_FAILED;
+    close(fd);
+    if (elf->data == MAP_FAILED) {
+        fprintf(stderr, "failed to map '%s'\n", path);
+        return CFGITEMS_FAILURE;
+    }
+
+    elf->ehdr = (const Elf64_Ehdr*)elf->data;
+    if (memcmp(elf->ehdr->e_ident, ELFMAG, SELFMAG) ||
+        (elf->ehdr->e_ident[EI_CLASS] != ELFCLASS64) ||
+        (elf->ehdr->e_ident[EI_DATA] != ELFDATA2LSB) ||
+        (elf->ehdr->e_shentsize != sizeof(Elf64_Shdr)) ||
+        (elf->ehdr->e_shoff + (uint64_t)elf->ehdr->e_shnum * sizeof(Elf64_Shdr) > elf->size) ||
+        (elf->ehdr->e_shstrndx >= elf->ehdr->e_shnum)) {
+        fprintf(stderr, "'%s' is not a supported (64-bit little-endian) ELF file\n", path);
+        elf_close(elf);
+        return CFGITEMS_FAILURE;
+    }
+
+    elf->shdrs = (const Elf64_Shdr*)(elf->data + elf->ehdr->e_shoff);
+
+    return CFGITEMS_SUCCESS;
+}
+
+void elf_close(struct elf_file* elf)
+{
+    free(elf->relocs);
+
+    if (elf->data != NULL && elf->data != MAP_FAILED) {
+        if (elf->writable)
+            msync(elf->data, elf->size, MS_SYNC);
+        munmap(elf->data, elf->size);
+    }
+}
+
+const Elf64_Shdr* elf_find_section(const struct elf_file* elf, const char* name)
+{
+    const Elf64_Shdr* shstrtab = &elf->shdrs[elf->ehdr->e_shstrndx];
+
+    for (size_t i = 0; i < elf->ehdr->e_shnum; ++i) {
+        const Elf64_Shdr* shdr = &elf->shdrs[i];
+
+        if (shdr->sh_name >= shstrtab->sh_size)
+            continue;
+
+        if (!strcmp((const char*)elf->data + shstrtab->sh_offset + shdr->sh_name, name))
+            return shdr->sh_type == SHT_PROGBITS ? shdr : NULL;
+    }
+
+    return NULL;
+}
+
+/*
+ * In position independent executables pointers stored in the items
+ * section are set by the dynamic loader. For RELA relocations the value
+ * is kept in the addend (RELR and REL relocations keep it in place).
+ */
+int elf_collect_relocs(struct elf_file* elf, const Elf64_Shdr* target)
+{
+    uint32_t relative;
+
+    switch (elf->ehdr->e_machine) {
+        case EM_X86_64:  relative = R_X86_64_RELATIVE;  break;
+        case EM_AARCH64: relative = R_AARCH64_RELATIVE; break;
+        default:         relative = 0;                  break;
+    }
+
+    for (int pass = 0; pass < 2; ++pass) {
+        size_t n = 0;
+
+        for (size_t i = 0; i < elf->ehdr->e_shnum; ++i) {
+            const Elf64_Shdr* shdr = &elf->shdrs[i];
+
+            if ((shdr->sh_type != SHT_RELA) || (shdr->sh_entsize != sizeof(Elf64_Rela)))
+                continue;
+
+            const Elf64_Rela* rela = (const Elf64_Rela*)(elf->data + shdr->sh_offset);
+            for (size_t j = 0; j < shdr->sh_size / sizeof(Elf64_Rela); ++j)
+                if ((ELF64_R_TYPE(rela[j].r_info) == relative) &&
+                    (rela[j].r_offset >= target->sh_addr) &&
+                    (rela[j].r_offset < target->sh_addr + target->sh_size)) {
+                    if (pass == 1)
+                        elf->relocs[n] = &rela[j];
+                    n++;
+                }
+        }
+
+        if (pass == 0) {
+            elf->relocs = calloc(n + 1, sizeof(const Elf64_Rela*));
+            if (elf->relocs == NULL)
+                return CFGITEMS_FAILURE;
+        }
+
+        elf->n_relocs = n;
+    }
+
+    qsort(elf->relocs, elf->n_relocs, sizeof(const Elf64_Rela*), compare_relocs);
+
+    return CFGITEMS_SUCCESS;
+}
+
+uint64_t elf_read_pointer(const struct elf_file* elf, const Elf64_Shdr* shdr, size_t offset)
+{
+    const Elf64_Rela key = {.r_offset = shdr->sh_addr + offset};
+    const Elf64_Rela* pkey = &key;
+    const Elf64_Rela* const* reloc;
+    uint64_t value;
+
+    reloc = bsearch(&pkey, elf->relocs, elf->n_relocs, sizeof(const Elf64_Rela*), compare_relocs);
+    if (reloc != NULL)
+        return (*reloc)->r_addend;
+
+    memcpy(&value, elf->data + shdr->sh_offset + offset, sizeof(value));
+
+    return value;
+}
+
+const char* elf_string_at(const struct elf_file* elf, uint64_t vaddr)
+{
+    for (size_t i = 0; i < elf->ehdr->e_shnum; ++i) {
+        const Elf64_Shdr* shdr = &elf->shdrs[i];
+
+        if (!(shdr->sh_flags & SHF_ALLOC) || (shdr->sh_type == SHT_NOBITS))
+            continue;
+
+        if ((vaddr >= shdr->sh_addr) && (vaddr < shdr->sh_addr + shdr->sh_size)) {
+            const char* str = (const char*)elf->data + shdr->sh_offset + (vaddr - shdr->sh_addr);
+            size_t max = shdr->sh_size - (vaddr - shdr->sh_addr);
+            return memchr(str, '\0', max) ? str : NULL;
+        }
+    }
+
+    return NULL;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
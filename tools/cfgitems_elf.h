@@ -0,0 +1,62 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_elf.h
+ *
+ * Access to executables (64-bit little-endian ELF files) shared by the tools.
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+#ifndef _CFGITEMS_ELF_H_
+#define _CFGITEMS_ELF_H_
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <elf.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global type definitions
+\*===========================================================================*/
+struct elf_file
+{
+    const char* path;
+    bool writable;
+    uint8_t* data;
+    size_t size;
+    const Elf64_Ehdr* ehdr;
+    const Elf64_Shdr* shdrs;
+    const Elf64_Rela** relocs; /* relative relocations patching the items section */
+    size_t n_relocs;
+};
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * function forward declarations (external linkage)
+\*===========================================================================*/
+int elf_open(struct elf_file* elf, const char* path, bool writable);
+void elf_close(struct elf_file* elf);
+const Elf64_Shdr* elf_find_section(const struct elf_file* elf, const char* name);
+int elf_collect_relocs(struct elf_file* elf, const Elf64_Shdr* target);
+uint64_t elf_read_pointer(const struct elf_file* elf, const Elf64_Shdr* shdr, size_t offset);
+const char* elf_string_at(const struct elf_file* elf, uint64_t vaddr);
+
+#endif /* _CFGITEMS_ELF_H_ */
@@ -0,0 +1,244 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_presort.c
+ *
+ * Post-link tool which fills the index section of an executable
+ * with the sorted order, the hash table, the module directory
+ * and the Bloom filter of its configuration items,
+ * so that cfgitems_init() does not have to build them at run time.
+ *
+ * The tool has to be built for the same ABI as the processed executable
+ * (it uses 'struct cfgitems' layout as seen by its own compiler).
+ * Only 64-bit little-endian ELF files are supported.
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <cfgitems_hash.h>
+#include <cfgitems_index.h>
+#include <cfgitems_module.h>
+#include <cfgitems_bloom.h>
+#include <cfgitems_elf.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+struct key
+{
+    const char* module;
+    const char* name;
+};
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static int compare_keys_indirect(const void* l, const void* r);
+static int presort(struct elf_file* elf);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+static const struct key* keys; /* used by compare_keys_indirect() */
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+int main(int argc, char* argv[])
+{
+    struct elf_file elf;
+    int status;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <executable>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (elf_open(&elf, argv[1], true) != CFGITEMS_SUCCESS)
+        return EXIT_FAILURE;
+
+    status = presort(&elf);
+
+    elf_close(&elf);
+
+    return status == CFGITEMS_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+static int compare_keys_indirect(const void* l, const void* r)
+{
+    const struct key* lk = &keys[*(const uint32_t*)l];
+    const struct key* rk = &keys[*(const uint32_t*)r];
+
+    return cfgitems_compare_keys(lk->module, lk->name, rk->module, rk->name);
+}
+
+static int presort(struct elf_file* elf)
+{
+    const Elf64_Shdr* items;
+    const Elf64_Shdr* index;
+    struct key* k;
+    uint32_t* words;
+    struct cfgitems_index_header* header;
+    uint32_t* order;
+    struct cfgitems_hash_slot* hash;
+    struct cfgitems_hash_slot* entries;
+    struct cfgitems_module* modules;
+    struct cfgitems_module* directory;
+    struct cfgitems_hash_slot* modules_hash;
+    uint32_t* bloom;
+    uint32_t* hashes;
+    size_t n_entries;
+    size_t n_items = 0;
+    size_t n_modules = 0;
+    size_t n_words;
+    int retval = CFGITEMS_FAILURE;
+
+    items = elf_find_section(elf, CFGITEMS_SECTION_NAME);
+    index = elf_find_section(elf, CFGITEMS_INDEX_SECTION_NAME);
+    if ((items == NULL) || (index == NULL)) {
+        fprintf(stderr, "'%s' has no '%s' or '%s' section\n",
+            elf->path, CFGITEMS_SECTION_NAME, CFGITEMS_INDEX_SECTION_NAME);
+        return CFGITEMS_FAILURE;
+    }
+
+    if ((items->sh_size % sizeof(struct cfgitems)) ||
+        (items->sh_offset + items->sh_size > elf->size) ||
+        (index->sh_offset + index->sh_size > elf->size)) {
+        fprintf(stderr, "'%s' has malformed '%s' section\n", elf->path, CFGITEMS_SECTION_NAME);
+        return CFGITEMS_FAILURE;
+    }
+
+    if (elf_collect_relocs(elf, items) != CFGITEMS_SUCCESS)
+        return CFGITEMS_FAILURE;
+
+    n_entries = items->sh_size / sizeof(struct cfgitems);
+    n_words = index->sh_size / sizeof(uint32_t);
+
+    k = calloc(n_entries, sizeof(struct key));
+    hashes = calloc(n_entries, sizeof(uint32_t));
+    entries = calloc(n_entries, sizeof(struct cfgitems_hash_slot));
+    modules = calloc(n_entries, sizeof(struct cfgitems_module));
+    words = calloc(n_words, sizeof(uint32_t));
+    if ((k == NULL) || (hashes == NULL) || (entries == NULL) || (modules == NULL) || (words == NULL))
+        goto out;
+
+    header = (struct cfgitems_index_header*)words;
+    order = (uint32_t*)(header + 1);
+
+    for (size_t i = 0; i < n_entries; ++i) {
+        size_t offset = i * sizeof(struct cfgitems);
+        uint64_t module = elf_read_pointer(elf, items, offset + offsetof(struct cfgitems, module));
+        uint64_t name = elf_read_pointer(elf, items, offset + offsetof(struct cfgitems, name));
+
+        if (module == 0)
+            continue;
+
+        k[i].module = elf_string_at(elf, module);
+        k[i].name = elf_string_at(elf, name);
+        if ((k[i].module == NULL) || (k[i].name == NULL)) {
+            fprintf(stderr, "'%s': cannot resolve key of configuration item #%zu\n", elf->path, i);
+            goto out;
+        }
+
+        if (CFGITEMS_INDEX_HEADER_WORDS + n_items < n_words)
+            order[n_items] = i;
+        n_items++;
+    }
+
+    if (n_words < cfgitems_index_words(n_items, 0)) {
+        fprintf(stderr, "'%s': '%s' section is too small (%zu words, %zu needed), "
+            "are the items compiled with CFGITEMS_PRESORT?\n",
+            elf->path, CFGITEMS_INDEX_SECTION_NAME, n_words, cfgitems_index_words(n_items, 0));
+        goto out;
+    }
+
+    keys = k;
+    qsort(order, n_items, sizeof(uint32_t), compare_keys_indirect);
+
+    for (size_t i = 1; i < n_items; ++i)
+        if (compare_keys_indirect(&order[i - 1], &order[i]) == 0) {
+            fprintf(stderr, "'%s': configuration item '%s' in module '%s' is defined more than once\n",
+                elf->path, k[order[i]].name, k[order[i]].module);
+            goto out;
+        }
+
+    hash = (struct cfgitems_hash_slot*)(order + n_items);
+    for (size_t i = 0; i < n_items; ++i) {
+        hashes[order[i]] = cfgitems_hash_key(k[order[i]].module, k[order[i]].name);
+        entries[i].hash = hashes[order[i]];
+        entries[i].id = order[i] + 1;
+    }
+    cfgitems_index_table_build(hash, cfgitems_index_table_size(n_items), entries, n_items);
+
+    for (size_t i = 0; i < n_items; ++i)
+        n_modules = cfgitems_module_add(modules, n_modules, k[order[i]].module,
+            i ? k[order[i - 1]].module : NULL, i);
+
+    if (n_words < cfgitems_index_words(n_items, n_modules)) {
+        fprintf(stderr, "'%s': '%s' section is too small (%zu words, %zu needed)\n",
+            elf->path, CFGITEMS_INDEX_SECTION_NAME, n_words, cfgitems_index_words(n_items, n_modules));
+        goto out;
+    }
+
+    directory = (struct cfgitems_module*)(hash + cfgitems_index_table_size(n_items));
+    memcpy(directory, modules, n_modules * sizeof(struct cfgitems_module));
+
+    modules_hash = (struct cfgitems_hash_slot*)(directory + n_modules);
+    for (size_t i = 0; i < n_modules; ++i)
+        cfgitems_hash_insert(modules_hash, cfgitems_hash_size(n_modules), modules[i].hash, i);
+
+    bloom = (uint32_t*)(modules_hash + cfgitems_hash_size(n_modules));
+    for (size_t i = 0; i < n_items; ++i)
+        cfgitems_bloom_add(bloom, cfgitems_bloom_words(n_items), hashes[order[i]]);
+
+    header->magic = CFGITEMS_INDEX_MAGIC;
+    header->version = CFGITEMS_INDEX_VERSION;
+    header->n_entries = n_entries;
+    header->n_items = n_items;
+    header->n_modules = n_modules;
+
+    memcpy(elf->data + index->sh_offset, words, n_words * sizeof(uint32_t));
+
+    /* store the hash in each item as well, so that cfgitems_init() need not compute it */
+    for (size_t i = 0; i < n_items; ++i)
+        memcpy(elf->data + items->sh_offset + order[i] * sizeof(struct cfgitems) +
+            offsetof(struct cfgitems, hash), &hashes[order[i]], sizeof(uint32_t));
+
+    retval = CFGITEMS_SUCCESS;
+
+out:
+    free(words);
+    free(modules);
+    free(entries);
+    free(hashes);
+    free(k);
+
+    return retval;
+}
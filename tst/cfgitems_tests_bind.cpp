@@ -0,0 +1,171 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_tests_bind.cpp
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <gtest/gtest.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+CFGITEMS_DEFINE_BOOL(CFGITEMS_GLOBAL_MODULE, multithreaded, false);
+CFGITEMS_DEFINE_STRING(CFGITEMS_GLOBAL_MODULE, configuration_file, "mystring1");
+CFGITEMS_DEFINE_DOUBLE(CFGITEMS_GLOBAL_MODULE, speed, 1.0);
+CFGITEMS_DEFINE_S8(submodule, s8, -1);
+CFGITEMS_DEFINE_U8(submodule, u8, 1);
+CFGITEMS_DEFINE_S16(submodule, s16, -1);
+CFGITEMS_DEFINE_U16(submodule, u16, 1);
+CFGITEMS_DEFINE_S32(submodule, s32, -1);
+CFGITEMS_DEFINE_U32(submodule, u32, 1);
+CFGITEMS_DEFINE_S64(submodule, s64, -1);
+CFGITEMS_DEFINE_U64(submodule, u64, 1);
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+static bool multithreaded;
+static char configuration_file[CFGITEMS_STRING_MAX];
+static double speed;
+static int8_t s8;
+static uint8_t u8;
+static int16_t s16;
+static uint16_t u16;
+static int32_t s32;
+static uint32_t u32;
+static uint32_t u32_too;
+static int64_t s64;
+static uint64_t u64;
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+TEST(cfgitems, cfgitems_bind)
+{
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_bind_bool(NULL, "multithreaded", &multithreaded));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_bind_string(NULL, "configuration_file",
+        configuration_file, sizeof(configuration_file)));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_bind_double(NULL, "speed", &speed));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_bind_s8("submodule", "s8", &s8));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_bind_u8("submodule", "u8", &u8));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_bind_s16("submodule", "s16", &s16));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_bind_u16("submodule", "u16", &u16));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_bind_s32("submodule", "s32", &s32));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_bind_u32("submodule", "u32", &u32));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_bind_u32("submodule", "u32", &u32_too));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_bind_s64("submodule", "s64", &s64));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_bind_u64("submodule", "u64", &u64));
+
+    /* variables are assigned with the current values at once */
+    EXPECT_FALSE(multithreaded);
+    EXPECT_STREQ("mystring1", configuration_file);
+    EXPECT_EQ(1.0, speed);
+    EXPECT_EQ(-1, s8);
+    EXPECT_EQ(1u, u32);
+    EXPECT_EQ(1u, u32_too);
+    EXPECT_EQ(1u, u64);
+
+    /* ... and then by the setters */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_bool(NULL, "multithreaded", true));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_string(NULL, "configuration_file", "mystring3"));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_u32("submodule", "u32", 3));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_s64_h(CFGITEMS_HANDLE(submodule, s64), -3));
+    EXPECT_TRUE(multithreaded);
+    EXPECT_STREQ("mystring3", configuration_file);
+    EXPECT_EQ(3u, u32);
+    EXPECT_EQ(3u, u32_too);
+    EXPECT_EQ(-3, s64);
+
+    /* ... by the transactions */
+    struct cfgitems_txn* txn = cfgitems_txn_begin();
+    ASSERT_NE(nullptr, txn);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_double(txn, NULL, "speed", 4.0));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_u16(txn, "submodule", "u16", 4));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_commit(txn));
+    EXPECT_EQ(4.0, speed);
+    EXPECT_EQ(4u, u16);
+
+    /* ... and by the parser */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_parse("configuration.file"));
+    EXPECT_TRUE(multithreaded);
+    EXPECT_STREQ("mystring2", configuration_file);
+    EXPECT_EQ(2.0, speed);
+    EXPECT_EQ(1, s8);
+    EXPECT_EQ(1u, u8);
+    EXPECT_EQ(1, s16);
+    EXPECT_EQ(1u, u16);
+    EXPECT_EQ(1, s32);
+    EXPECT_EQ(1u, u32);
+    EXPECT_EQ(1u, u32_too);
+    EXPECT_EQ(1, s64);
+    EXPECT_EQ(1u, u64);
+}
+
+TEST(cfgitems, cfgitems_bind_failures)
+{
+    uint32_t value = 7;
+
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_bind_u32("submodule", "u33", &value));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_bind_u32("submodule", "u64", &value));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_bind_u32("submodule", "u32", NULL));
+    EXPECT_EQ(7u, value);
+
+    /* not every value of the item would fit */
+    char small[CFGITEMS_STRING_MAX - 1] = "x";
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_bind_string(NULL, "configuration_file", small, sizeof(small)));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_bind_string(NULL, "configuration_file", NULL, CFGITEMS_STRING_MAX));
+    EXPECT_STREQ("x", small);
+}
+
+int main(int argc, char* argv[])
+{
+    int retval = EXIT_FAILURE;
+
+    do {
+        int status;
+
+        ::testing::InitGoogleTest(&argc, argv);
+
+        status = cfgitems_init(NULL);
+        if (status != CFGITEMS_SUCCESS)
+        {
+            break;
+        }
+
+        retval = RUN_ALL_TESTS();
+    } while (0);
+
+    return retval;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
@@ -0,0 +1,319 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_tests_compiled.cpp
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <cfgitems_image.h>
+#include <gtest/gtest.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+CFGITEMS_DEFINE_U32(CFGITEMS_GLOBAL_MODULE, u32, 1);
+CFGITEMS_DEFINE_BOOL(compiled, bool, false);
+CFGITEMS_DEFINE_STRING(compiled, string, "default");
+CFGITEMS_DEFINE_DOUBLE(compiled, double, 0.0);
+CFGITEMS_DEFINE_S8(compiled, s8, 0);
+CFGITEMS_DEFINE_U8(compiled, u8, 0);
+CFGITEMS_DEFINE_S16(compiled, s16, 0);
+CFGITEMS_DEFINE_U16(compiled, u16, 0);
+CFGITEMS_DEFINE_S32(compiled, s32, 0);
+CFGITEMS_DEFINE_S64(compiled, s64, 0);
+CFGITEMS_DEFINE_U64(compiled, u64, 0);
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static bool compile(const std::string& configuration);
+static std::string read_file(const std::string& path);
+static void write_file(const std::string& path, const std::string& content);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+static std::string compiler; /* path to cfgitems-compile */
+static std::string executable; /* path to this executable */
+static std::string directory;
+static std::string source;
+static std::string image;
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+TEST(cfgitems, cfgitems_load_compiled)
+{
+    const char* str;
+    bool b;
+    double d;
+    int8_t s8;
+    uint8_t u8;
+    int16_t s16;
+    uint16_t u16;
+    int32_t s32;
+    uint32_t u32;
+    int64_t s64;
+    uint64_t u64;
+
+    ASSERT_TRUE(compile(
+        "u32 = 0x20\n"
+        "[compiled]\n"
+        "bool = on\n"
+        "string = \"compiled string\"\n"
+        "double = -2.5\n"
+        "s8 = -8\n"
+        "u8 = 8\n"
+        "u8 = 300 ; out of range, ignored\n"
+        "s16 = -16\n"
+        "u16 = 0x10\n"
+        "s32 = 1\n"
+        "s32 = -32 ; the last one wins\n"
+        "s64 = -64\n"
+        "u64 = -1\n"
+        "unknown = 1\n"
+        "[othermodule]\n"
+        "s8 = 100\n"));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_load_compiled(image.c_str()));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32(NULL, "u32", &u32));
+    EXPECT_EQ(32u, u32);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_bool("compiled", "bool", &b));
+    EXPECT_TRUE(b);
+    cfgitems_read_lock();
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_string("compiled", "string", &str));
+    EXPECT_STREQ("compiled", str);
+    cfgitems_read_unlock();
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_double("compiled", "double", &d));
+    EXPECT_EQ(-2.5, d);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s8("compiled", "s8", &s8));
+    EXPECT_EQ(-8, s8);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u8("compiled", "u8", &u8));
+    EXPECT_EQ(8, u8);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s16("compiled", "s16", &s16));
+    EXPECT_EQ(-16, s16);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u16("compiled", "u16", &u16));
+    EXPECT_EQ(16, u16);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s32("compiled", "s32", &s32));
+    EXPECT_EQ(-32, s32);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s64("compiled", "s64", &s64));
+    EXPECT_EQ(-64, s64);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u64("compiled", "u64", &u64));
+    EXPECT_EQ(UINT64_MAX, u64);
+
+    /* items missing from the configuration are left as they are */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_s8("compiled", "s8", 1));
+    ASSERT_TRUE(compile("[compiled]\nstring = \"\"\n"));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_load_compiled(image.c_str()));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s8("compiled", "s8", &s8));
+    EXPECT_EQ(1, s8);
+    cfgitems_read_lock();
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_string("compiled", "string", &str));
+    EXPECT_STREQ("", str);
+    cfgitems_read_unlock();
+
+    /* too long strings are ignored, just like invalid numbers */
+    ASSERT_TRUE(compile("[compiled]\nstring = valid\nstring = " + std::string(CFGITEMS_STRING_MAX, 'x') +
+        "\ns8 = 3\n"));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_load_compiled(image.c_str()));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s8("compiled", "s8", &s8));
+    EXPECT_EQ(3, s8);
+    cfgitems_read_lock();
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_string("compiled", "string", &str));
+    EXPECT_STREQ("valid", str);
+    cfgitems_read_unlock();
+
+    ASSERT_TRUE(compile(""));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_load_compiled(image.c_str()));
+}
+
+TEST(cfgitems, cfgitems_load_compiled_rejected)
+{
+    std::string compiled;
+    std::string modified;
+    uint32_t u32;
+
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_load_compiled(NULL));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_load_compiled((directory + "/nonexistent").c_str()));
+
+    ASSERT_TRUE(compile("u32 = 64\n"));
+    compiled = read_file(image);
+    ASSERT_LT(32u, compiled.size());
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_u32(NULL, "u32", 1));
+
+    /* not compiled at all */
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_load_compiled(source.c_str()));
+
+    /* truncated */
+    write_file(image, compiled.substr(0, compiled.size() - 1));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_load_compiled(image.c_str()));
+
+    /* corrupted value */
+    modified = compiled;
+    modified[modified.size() - 8] ^= 1;
+    write_file(image, modified);
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_load_compiled(image.c_str()));
+
+    /* compiled for other configuration items */
+    modified = compiled;
+    modified[8] ^= 1;
+    write_file(image, modified);
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_load_compiled(image.c_str()));
+
+    /* of another version */
+    modified = compiled;
+    modified[4] ^= 0x80;
+    write_file(image, modified);
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_load_compiled(image.c_str()));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32(NULL, "u32", &u32));
+    EXPECT_EQ(1u, u32);
+
+    write_file(image, compiled);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_load_compiled(image.c_str()));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32(NULL, "u32", &u32));
+    EXPECT_EQ(64u, u32);
+
+    /* the executable the configuration is compiled for has to have configuration items */
+    EXPECT_NE(0, system(("'" + compiler + "' '" + compiler + "' '" + source + "' '" + image + "' 2>/dev/null").c_str()));
+}
+
+TEST(cfgitems, cfgitems_load_compiled_string_too_long)
+{
+    struct cfgitems_image_header* header;
+    struct cfgitems_image_value* values;
+    std::string compiled;
+    const char* str;
+    int32_t s32;
+    uint32_t u32;
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_u32(NULL, "u32", 1));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_string("compiled", "string", "before"));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_s32("compiled", "s32", 2));
+
+    /* the only string of the image becomes too long (with a valid checksum) */
+    ASSERT_TRUE(compile("u32 = 7\n[compiled]\nstring = x\ns32 = 9\n"));
+    compiled = read_file(image) + std::string(CFGITEMS_STRING_MAX, 'x');
+    header = reinterpret_cast<struct cfgitems_image_header*>(&compiled[0]);
+    values = reinterpret_cast<struct cfgitems_image_value*>(header + 1);
+    ASSERT_EQ(1u, header->strings_size);
+    for (uint32_t i = 0; i < header->n_values; ++i)
+        if (values[i].type == CFGITEMS_TYPE_STRING)
+            values[i].length += CFGITEMS_STRING_MAX;
+    header->strings_size += CFGITEMS_STRING_MAX;
+    header->checksum = cfgitems_digest(&compiled[sizeof(*header)], compiled.size() - sizeof(*header));
+    write_file(image, compiled);
+
+    /* none of the values is applied */
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_load_compiled(image.c_str()));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32(NULL, "u32", &u32));
+    EXPECT_EQ(1u, u32);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s32("compiled", "s32", &s32));
+    EXPECT_EQ(2, s32);
+    cfgitems_read_lock();
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_string("compiled", "string", &str));
+    EXPECT_STREQ("before", str);
+    cfgitems_read_unlock();
+}
+
+int main(int argc, char* argv[])
+{
+    int retval = EXIT_FAILURE;
+    char tmpl[] = "/tmp/cfgitems_tests_compiled.XXXXXX";
+    char path[4096];
+    ssize_t len;
+
+    do {
+        int status;
+
+        ::testing::InitGoogleTest(&argc, argv);
+
+        if (argc != 2) {
+            fprintf(stderr, "usage: %s <cfgitems-compile>\n", argv[0]);
+            break;
+        }
+
+        len = readlink("/proc/self/exe", path, sizeof(path) - 1);
+        if ((len < 0) || (mkdtemp(tmpl) == NULL))
+            break;
+
+        path[len] = '\0';
+        compiler = argv[1];
+        executable = path;
+        directory = tmpl;
+        source = directory + "/configuration.ini";
+        image = directory + "/configuration.bin";
+
+        status = cfgitems_init(NULL);
+        if (status != CFGITEMS_SUCCESS)
+        {
+            break;
+        }
+
+        retval = RUN_ALL_TESTS();
+
+        unlink(source.c_str());
+        unlink(image.c_str());
+        rmdir(tmpl);
+    } while (0);
+
+    return retval;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+/*
+ * Compiles the configuration for this very executable.
+ */
+static bool compile(const std::string& configuration)
+{
+    write_file(source, configuration);
+
+    return system(("'" + compiler + "' '" + executable + "' '" + source + "' '" + image + "'").c_str()) == 0;
+}
+
+static std::string read_file(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void write_file(const std::string& path, const std::string& content)
+{
+    FILE* file = fopen(path.c_str(), "w");
+
+    ASSERT_NE(nullptr, file);
+    EXPECT_EQ(content.size(), fwrite(content.data(), 1, content.size(), file));
+    fclose(file);
+}
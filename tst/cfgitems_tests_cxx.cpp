@@ -0,0 +1,101 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_tests_cxx.cpp
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.hpp>
+#include <gtest/gtest.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+CFGITEMS_DEFINE_U32(CFGITEMS_GLOBAL_MODULE, u32, 1);
+CFGITEMS_DEFINE_STRING(CFGITEMS_GLOBAL_MODULE, configuration_file, "mystring1");
+CFGITEMS_DEFINE_U32(submodule, u32, 2);
+CFGITEMS_DEFINE_DOUBLE(submodule, speed, 3.0);
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+static_assert(CFGITEMS_KEY("submodule", "u32").hash == lts::cfgitems::hash_key("submodule", "u32"),
+    "hash_key() shall be evaluated at compile time");
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+TEST(cfgitems, cfgitems_cxx_hash)
+{
+    /* items defined in C++ carry their hashes */
+    EXPECT_EQ(CFGITEMS_KEY(nullptr, "u32").hash, CFGITEMS_HANDLE(CFGITEMS_GLOBAL_MODULE, u32)->hash);
+    EXPECT_EQ(CFGITEMS_KEY("submodule", "u32").hash, CFGITEMS_HANDLE(submodule, u32)->hash);
+    EXPECT_EQ(CFGITEMS_KEY("submodule", "speed").hash, CFGITEMS_HANDLE(submodule, speed)->hash);
+    EXPECT_NE(CFGITEMS_KEY("submodule", "u32").hash, CFGITEMS_KEY(nullptr, "u32").hash);
+}
+
+TEST(cfgitems, cfgitems_cxx_get_set)
+{
+    uint32_t u32;
+    double d;
+    const char* str;
+    cfgitems_handle_t handle;
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_init(NULL));
+
+    /* compile time hashes shall match the ones computed by the library */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32(NULL, "u32", &u32));
+    EXPECT_EQ(1u, u32);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("submodule", "u32", &u32));
+    EXPECT_EQ(2u, u32);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, lts::cfgitems::get(CFGITEMS_KEY(nullptr, "u32"), &u32));
+    EXPECT_EQ(1u, u32);
+    EXPECT_EQ(CFGITEMS_SUCCESS, lts::cfgitems::get(CFGITEMS_KEY("submodule", "speed"), &d));
+    EXPECT_EQ(3.0, d);
+    EXPECT_EQ(CFGITEMS_SUCCESS, lts::cfgitems::get(CFGITEMS_KEY(nullptr, "configuration_file"), &str));
+    EXPECT_STREQ("mystring1", str);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, lts::cfgitems::set(CFGITEMS_KEY("submodule", "u32"), 20u));
+    EXPECT_EQ(20u, CFGITEMS_GET(submodule, u32));
+    EXPECT_EQ(CFGITEMS_SUCCESS, lts::cfgitems::set(CFGITEMS_KEY("submodule", "speed"), 30.0));
+    EXPECT_EQ(30.0, CFGITEMS_GET(submodule, speed));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, lts::cfgitems::lookup<uint32_t>(CFGITEMS_KEY("submodule", "u32"), &handle));
+    EXPECT_EQ(CFGITEMS_HANDLE(submodule, u32), handle);
+
+    /* wrong type, unknown item, wrong hash */
+    EXPECT_EQ(CFGITEMS_FAILURE, lts::cfgitems::get(CFGITEMS_KEY("submodule", "u32"), &d));
+    EXPECT_EQ(CFGITEMS_FAILURE, lts::cfgitems::get(CFGITEMS_KEY("submodule", "u64"), &u32));
+    EXPECT_EQ(CFGITEMS_FAILURE, lts::cfgitems::get(lts::cfgitems::key("submodule", "u32", 0), &u32));
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
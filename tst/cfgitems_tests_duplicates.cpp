@@ -0,0 +1,79 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_tests_duplicates.cpp
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <gtest/gtest.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+CFGITEMS_DEFINE_U32(submodule, u32, 1);
+
+/*
+ * Item with the same (module, name) key as the one above, but defined
+ * under a different symbol (as it would be e.g. by a hand written definition).
+ */
+union cfgitems_any cfgitems_submodule_u32_duplicate_value = {._U32_ = 2};
+
+struct cfgitems cfgitems_submodule_u32_duplicate
+    __attribute__((__section__(CFGITEMS_SECTION_NAME)))
+    __attribute__((__used__))
+    __attribute__((aligned(CFGITEMS_ALIGN))) =
+    {
+        .module = "submodule",
+        .type   = CFGITEMS_TYPE_U32,
+        .name   = "u32",
+        .value  = &cfgitems_submodule_u32_duplicate_value
+    };
+
+CFGITEMS_DEFINE_U32(submodule, u16, 3);
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+TEST(cfgitems, cfgitems_init_with_duplicates)
+{
+    uint32_t value;
+
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_init(NULL));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_get_u32("submodule", "u32", &value));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_get_u32("submodule", "u16", &value));
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
@@ -0,0 +1,274 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_tests_freeze.cpp
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <gtest/gtest.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+CFGITEMS_DEFINE_BOOL(CFGITEMS_GLOBAL_MODULE, multithreaded, false);
+CFGITEMS_DEFINE_STRING(submodule, configuration_file, "mystring1");
+CFGITEMS_DEFINE_U32(submodule, u32, 1);
+
+/* enough items for the items section to span a few pages */
+CFGITEMS_DEFINE_U32(bulk, u32_000, 0);
+CFGITEMS_DEFINE_U32(bulk, u32_001, 1);
+CFGITEMS_DEFINE_U32(bulk, u32_002, 2);
+CFGITEMS_DEFINE_U32(bulk, u32_003, 3);
+CFGITEMS_DEFINE_U32(bulk, u32_004, 4);
+CFGITEMS_DEFINE_U32(bulk, u32_005, 5);
+CFGITEMS_DEFINE_U32(bulk, u32_006, 6);
+CFGITEMS_DEFINE_U32(bulk, u32_007, 7);
+CFGITEMS_DEFINE_U32(bulk, u32_008, 8);
+CFGITEMS_DEFINE_U32(bulk, u32_009, 9);
+CFGITEMS_DEFINE_U32(bulk, u32_010, 10);
+CFGITEMS_DEFINE_U32(bulk, u32_011, 11);
+CFGITEMS_DEFINE_U32(bulk, u32_012, 12);
+CFGITEMS_DEFINE_U32(bulk, u32_013, 13);
+CFGITEMS_DEFINE_U32(bulk, u32_014, 14);
+CFGITEMS_DEFINE_U32(bulk, u32_015, 15);
+CFGITEMS_DEFINE_U32(bulk, u32_016, 16);
+CFGITEMS_DEFINE_U32(bulk, u32_017, 17);
+CFGITEMS_DEFINE_U32(bulk, u32_018, 18);
+CFGITEMS_DEFINE_U32(bulk, u32_019, 19);
+CFGITEMS_DEFINE_U32(bulk, u32_020, 20);
+CFGITEMS_DEFINE_U32(bulk, u32_021, 21);
+CFGITEMS_DEFINE_U32(bulk, u32_022, 22);
+CFGITEMS_DEFINE_U32(bulk, u32_023, 23);
+CFGITEMS_DEFINE_U32(bulk, u32_024, 24);
+CFGITEMS_DEFINE_U32(bulk, u32_025, 25);
+CFGITEMS_DEFINE_U32(bulk, u32_026, 26);
+CFGITEMS_DEFINE_U32(bulk, u32_027, 27);
+CFGITEMS_DEFINE_U32(bulk, u32_028, 28);
+CFGITEMS_DEFINE_U32(bulk, u32_029, 29);
+CFGITEMS_DEFINE_U32(bulk, u32_030, 30);
+CFGITEMS_DEFINE_U32(bulk, u32_031, 31);
+CFGITEMS_DEFINE_U32(bulk, u32_032, 32);
+CFGITEMS_DEFINE_U32(bulk, u32_033, 33);
+CFGITEMS_DEFINE_U32(bulk, u32_034, 34);
+CFGITEMS_DEFINE_U32(bulk, u32_035, 35);
+CFGITEMS_DEFINE_U32(bulk, u32_036, 36);
+CFGITEMS_DEFINE_U32(bulk, u32_037, 37);
+CFGITEMS_DEFINE_U32(bulk, u32_038, 38);
+CFGITEMS_DEFINE_U32(bulk, u32_039, 39);
+CFGITEMS_DEFINE_U32(bulk, u32_040, 40);
+CFGITEMS_DEFINE_U32(bulk, u32_041, 41);
+CFGITEMS_DEFINE_U32(bulk, u32_042, 42);
+CFGITEMS_DEFINE_U32(bulk, u32_043, 43);
+CFGITEMS_DEFINE_U32(bulk, u32_044, 44);
+CFGITEMS_DEFINE_U32(bulk, u32_045, 45);
+CFGITEMS_DEFINE_U32(bulk, u32_046, 46);
+CFGITEMS_DEFINE_U32(bulk, u32_047, 47);
+CFGITEMS_DEFINE_U32(bulk, u32_048, 48);
+CFGITEMS_DEFINE_U32(bulk, u32_049, 49);
+CFGITEMS_DEFINE_U32(bulk, u32_050, 50);
+CFGITEMS_DEFINE_U32(bulk, u32_051, 51);
+CFGITEMS_DEFINE_U32(bulk, u32_052, 52);
+CFGITEMS_DEFINE_U32(bulk, u32_053, 53);
+CFGITEMS_DEFINE_U32(bulk, u32_054, 54);
+CFGITEMS_DEFINE_U32(bulk, u32_055, 55);
+CFGITEMS_DEFINE_U32(bulk, u32_056, 56);
+CFGITEMS_DEFINE_U32(bulk, u32_057, 57);
+CFGITEMS_DEFINE_U32(bulk, u32_058, 58);
+CFGITEMS_DEFINE_U32(bulk, u32_059, 59);
+CFGITEMS_DEFINE_U32(bulk, u32_060, 60);
+CFGITEMS_DEFINE_U32(bulk, u32_061, 61);
+CFGITEMS_DEFINE_U32(bulk, u32_062, 62);
+CFGITEMS_DEFINE_U32(bulk, u32_063, 63);
+CFGITEMS_DEFINE_U32(bulk, u32_064, 64);
+CFGITEMS_DEFINE_U32(bulk, u32_065, 65);
+CFGITEMS_DEFINE_U32(bulk, u32_066, 66);
+CFGITEMS_DEFINE_U32(bulk, u32_067, 67);
+CFGITEMS_DEFINE_U32(bulk, u32_068, 68);
+CFGITEMS_DEFINE_U32(bulk, u32_069, 69);
+CFGITEMS_DEFINE_U32(bulk, u32_070, 70);
+CFGITEMS_DEFINE_U32(bulk, u32_071, 71);
+CFGITEMS_DEFINE_U32(bulk, u32_072, 72);
+CFGITEMS_DEFINE_U32(bulk, u32_073, 73);
+CFGITEMS_DEFINE_U32(bulk, u32_074, 74);
+CFGITEMS_DEFINE_U32(bulk, u32_075, 75);
+CFGITEMS_DEFINE_U32(bulk, u32_076, 76);
+CFGITEMS_DEFINE_U32(bulk, u32_077, 77);
+CFGITEMS_DEFINE_U32(bulk, u32_078, 78);
+CFGITEMS_DEFINE_U32(bulk, u32_079, 79);
+CFGITEMS_DEFINE_U32(bulk, u32_080, 80);
+CFGITEMS_DEFINE_U32(bulk, u32_081, 81);
+CFGITEMS_DEFINE_U32(bulk, u32_082, 82);
+CFGITEMS_DEFINE_U32(bulk, u32_083, 83);
+CFGITEMS_DEFINE_U32(bulk, u32_084, 84);
+CFGITEMS_DEFINE_U32(bulk, u32_085, 85);
+CFGITEMS_DEFINE_U32(bulk, u32_086, 86);
+CFGITEMS_DEFINE_U32(bulk, u32_087, 87);
+CFGITEMS_DEFINE_U32(bulk, u32_088, 88);
+CFGITEMS_DEFINE_U32(bulk, u32_089, 89);
+CFGITEMS_DEFINE_U32(bulk, u32_090, 90);
+CFGITEMS_DEFINE_U32(bulk, u32_091, 91);
+CFGITEMS_DEFINE_U32(bulk, u32_092, 92);
+CFGITEMS_DEFINE_U32(bulk, u32_093, 93);
+CFGITEMS_DEFINE_U32(bulk, u32_094, 94);
+CFGITEMS_DEFINE_U32(bulk, u32_095, 95);
+CFGITEMS_DEFINE_U32(bulk, u32_096, 96);
+CFGITEMS_DEFINE_U32(bulk, u32_097, 97);
+CFGITEMS_DEFINE_U32(bulk, u32_098, 98);
+CFGITEMS_DEFINE_U32(bulk, u32_099, 99);
+CFGITEMS_DEFINE_U32(bulk, u32_100, 100);
+CFGITEMS_DEFINE_U32(bulk, u32_101, 101);
+CFGITEMS_DEFINE_U32(bulk, u32_102, 102);
+CFGITEMS_DEFINE_U32(bulk, u32_103, 103);
+CFGITEMS_DEFINE_U32(bulk, u32_104, 104);
+CFGITEMS_DEFINE_U32(bulk, u32_105, 105);
+CFGITEMS_DEFINE_U32(bulk, u32_106, 106);
+CFGITEMS_DEFINE_U32(bulk, u32_107, 107);
+CFGITEMS_DEFINE_U32(bulk, u32_108, 108);
+CFGITEMS_DEFINE_U32(bulk, u32_109, 109);
+CFGITEMS_DEFINE_U32(bulk, u32_110, 110);
+CFGITEMS_DEFINE_U32(bulk, u32_111, 111);
+CFGITEMS_DEFINE_U32(bulk, u32_112, 112);
+CFGITEMS_DEFINE_U32(bulk, u32_113, 113);
+CFGITEMS_DEFINE_U32(bulk, u32_114, 114);
+CFGITEMS_DEFINE_U32(bulk, u32_115, 115);
+CFGITEMS_DEFINE_U32(bulk, u32_116, 116);
+CFGITEMS_DEFINE_U32(bulk, u32_117, 117);
+CFGITEMS_DEFINE_U32(bulk, u32_118, 118);
+CFGITEMS_DEFINE_U32(bulk, u32_119, 119);
+CFGITEMS_DEFINE_U32(bulk, u32_120, 120);
+CFGITEMS_DEFINE_U32(bulk, u32_121, 121);
+CFGITEMS_DEFINE_U32(bulk, u32_122, 122);
+CFGITEMS_DEFINE_U32(bulk, u32_123, 123);
+CFGITEMS_DEFINE_U32(bulk, u32_124, 124);
+CFGITEMS_DEFINE_U32(bulk, u32_125, 125);
+CFGITEMS_DEFINE_U32(bulk, u32_126, 126);
+CFGITEMS_DEFINE_U32(bulk, u32_127, 127);
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/* an item lying entirely within a page which is write protected once the items are frozen */
+static inline struct cfgitems* protected_item(void)
+{
+    uintptr_t page_size = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t first = ((uintptr_t)&CFGITEMS_SECTION_START + page_size - 1) & ~(page_size - 1);
+    uintptr_t last = (uintptr_t)&CFGITEMS_SECTION_END & ~(page_size - 1);
+
+    for (struct cfgitems* it = &CFGITEMS_SECTION_START; it < &CFGITEMS_SECTION_END; ++it)
+        if (((uintptr_t)it >= first) && ((uintptr_t)(it + 1) <= last))
+            return it;
+
+    return NULL;
+}
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+TEST(cfgitems, cfgitems_freeze)
+{
+    struct cfgitems_txn* txn;
+    const struct cfgitems_snapshot* snapshot;
+    const char* str;
+    uint32_t u32;
+    uint32_t bound = 0;
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_u32("submodule", "u32", 2));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_freeze());
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_freeze());
+
+    /* no updates any more ... */
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_set_u32("submodule", "u32", 3));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_set_u32_h(CFGITEMS_HANDLE(submodule, u32), 3));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_set_bool(NULL, "multithreaded", true));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_set_string("submodule", "configuration_file", "mystring2"));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_parse("configuration.file"));
+
+    txn = cfgitems_txn_begin();
+    ASSERT_NE(nullptr, txn);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_u32(txn, "submodule", "u32", 3));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_txn_commit(txn));
+
+    /* ... but reading works as before */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("submodule", "u32", &u32));
+    EXPECT_EQ(2u, u32);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32_h(CFGITEMS_HANDLE(bulk, u32_127), &u32));
+    EXPECT_EQ(127u, u32);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_string("submodule", "configuration_file", &str));
+    EXPECT_STREQ("mystring1", str);
+    EXPECT_FALSE(CFGITEMS_GET(_, multithreaded));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_bind_u32("submodule", "u32", &bound));
+    EXPECT_EQ(2u, bound);
+
+    snapshot = cfgitems_snapshot_acquire();
+    ASSERT_NE(nullptr, snapshot);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_snapshot_get_u32(snapshot, CFGITEMS_HANDLE(submodule, u32), &u32));
+    EXPECT_EQ(2u, u32);
+    cfgitems_snapshot_release(snapshot);
+}
+
+TEST(cfgitems, cfgitems_freeze_protection)
+{
+    struct cfgitems* it = protected_item();
+
+    ASSERT_NE(nullptr, it);
+
+    /* stray writes fault */
+    EXPECT_DEATH(it->hash = 0, "");
+}
+
+int main(int argc, char* argv[])
+{
+    int retval = EXIT_FAILURE;
+
+    do {
+        int status;
+
+        ::testing::InitGoogleTest(&argc, argv);
+
+        EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_freeze());
+
+        status = cfgitems_init(NULL);
+        if (status != CFGITEMS_SUCCESS)
+        {
+            break;
+        }
+
+        retval = RUN_ALL_TESTS();
+    } while (0);
+
+    return retval;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
@@ -0,0 +1,187 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_tests_notify.cpp
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <gtest/gtest.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+struct counter
+{
+    std::atomic<int> calls{0};
+    std::atomic<uint32_t> value{0};
+};
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+CFGITEMS_DEFINE_BOOL(CFGITEMS_GLOBAL_MODULE, multithreaded, false);
+CFGITEMS_DEFINE_U32(CFGITEMS_GLOBAL_MODULE, u32, 0);
+CFGITEMS_DEFINE_U32(submodule, u32, 0);
+CFGITEMS_DEFINE_U64(submodule, u64, 0);
+CFGITEMS_DEFINE_STRING(submodule, configuration_file, "mystring");
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static void count(cfgitems_handle_t handle, void* ctx);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+static std::atomic<bool> gate_entered{false};
+static std::atomic<bool> gate_open{true};
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+TEST(cfgitems, cfgitems_subscribe)
+{
+    counter c;
+
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_subscribe("submodule", "u16", count, &c));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_subscribe("x", "u32", count, &c));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_subscribe("x", "*", count, &c));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_subscribe("submodule", NULL, count, &c));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_subscribe("submodule", "u32", NULL, &c));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_subscribe("submodule", "u32", count, &c));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_u32("submodule", "u32", 7));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_u32(NULL, "u32", 8)); /* other module */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_u64("submodule", "u64", 9)); /* other item */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_flush_notifications());
+    EXPECT_EQ(1, c.calls);
+    EXPECT_EQ(7u, c.value);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_unsubscribe("submodule", "u32", count, &c));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_unsubscribe("submodule", "u32", count, &c));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_u32("submodule", "u32", 10));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_flush_notifications());
+    EXPECT_EQ(1, c.calls);
+}
+
+TEST(cfgitems, cfgitems_subscribe_wildcard)
+{
+    counter c;
+    struct cfgitems_txn* txn;
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_subscribe("submodule", "*", count, &c));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_u64("submodule", "u64", 1));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_string("submodule", "configuration_file", "x"));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_u32(NULL, "u32", 1));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_flush_notifications());
+    EXPECT_EQ(2, c.calls);
+
+    /* transactions and the parser notify as well */
+    txn = cfgitems_txn_begin();
+    ASSERT_NE(nullptr, txn);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_u32(txn, "submodule", "u32", 11));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_commit(txn));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_flush_notifications());
+    EXPECT_EQ(3, c.calls);
+    EXPECT_EQ(11u, c.value);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_parse("configuration.file"));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_flush_notifications());
+    EXPECT_EQ(6, c.calls); /* u32, u64 and configuration_file of [submodule] */
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_unsubscribe("submodule", "*", count, &c));
+}
+
+TEST(cfgitems, cfgitems_subscribe_coalescing)
+{
+    counter gate;
+    counter c;
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_subscribe(NULL, "multithreaded", count, &gate));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_subscribe("submodule", "u32", count, &c));
+
+    /* keep the dispatcher busy with the gate ... */
+    gate_open = false;
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_bool(NULL, "multithreaded", true));
+    while (!gate_entered)
+        std::this_thread::yield();
+
+    /* ... so that all these changes are seen by the subscriber as a single one */
+    for (uint32_t k = 1; k <= 1000; ++k)
+        EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_u32("submodule", "u32", k));
+
+    gate_open = true;
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_flush_notifications());
+    EXPECT_EQ(1, gate.calls);
+    EXPECT_EQ(1, c.calls);
+    EXPECT_EQ(1000u, c.value);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_unsubscribe(NULL, "multithreaded", count, &gate));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_unsubscribe("submodule", "u32", count, &c));
+}
+
+int main(int argc, char* argv[])
+{
+    int retval = EXIT_FAILURE;
+
+    do {
+        int status;
+
+        ::testing::InitGoogleTest(&argc, argv);
+
+        status = cfgitems_init(NULL);
+        if (status != CFGITEMS_SUCCESS)
+        {
+            break;
+        }
+
+        retval = RUN_ALL_TESTS();
+    } while (0);
+
+    return retval;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+static void count(cfgitems_handle_t handle, void* ctx)
+{
+    counter* c = static_cast<counter*>(ctx);
+    uint32_t u32 = 0;
+
+    if (handle->type == CFGITEMS_TYPE_BOOL) {
+        gate_entered = true;
+        while (!gate_open)
+            std::this_thread::yield();
+    }
+
+    if (handle->type == CFGITEMS_TYPE_U32)
+        cfgitems_get_u32_h(handle, &u32);
+
+    c->value = u32;
+    c->calls++;
+}
@@ -0,0 +1,101 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_tests_presorted.cpp
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <gtest/gtest.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+/* defined in reverse order on purpose */
+CFGITEMS_DEFINE_U64(submodule2, u64, 6);
+CFGITEMS_DEFINE_STRING(submodule2, configuration_file, "mystring3");
+CFGITEMS_DEFINE_U64(submodule, u64, 4);
+CFGITEMS_DEFINE_STRING(submodule, configuration_file, "mystring2");
+CFGITEMS_DEFINE_U64(CFGITEMS_GLOBAL_MODULE, u64, 2);
+CFGITEMS_DEFINE_STRING(CFGITEMS_GLOBAL_MODULE, configuration_file, "mystring1");
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static int count_items(cfgitems_handle_t handle, void* arg);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+TEST(cfgitems, cfgitems_init_presorted)
+{
+    uint64_t value;
+    const char* str;
+    int count = 0;
+    uint64_t misses;
+
+    /* index section is filled in by cfgitems-presort */
+    EXPECT_NE(0u, CFGITEMS_INDEX_SECTION_START[0]);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_init(NULL));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_init(NULL));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u64(NULL, "u64", &value));
+    EXPECT_EQ(2u, value);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u64("submodule", "u64", &value));
+    EXPECT_EQ(4u, value);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u64("submodule2", "u64", &value));
+    EXPECT_EQ(6u, value);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_string(NULL, "configuration_file", &str));
+    EXPECT_STREQ("mystring1", str);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_string("submodule", "configuration_file", &str));
+    EXPECT_STREQ("mystring2", str);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_string("submodule2", "configuration_file", &str));
+    EXPECT_STREQ("mystring3", str);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_foreach_in_module("submodule2", count_items, &count));
+    EXPECT_EQ(2, count);
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_foreach_in_module("submodule3", count_items, &count));
+
+    misses = cfgitems_filtered_misses();
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_get_u64("submodule3", "u64", &value));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_get_u64("submodule", "u32", &value));
+    EXPECT_LT(misses, cfgitems_filtered_misses());
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+static int count_items(cfgitems_handle_t handle, void* arg)
+{
+    ++*static_cast<int*>(arg);
+
+    return CFGITEMS_SUCCESS;
+}
@@ -0,0 +1,234 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_tests_reload.cpp
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <gtest/gtest.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+#define DEBOUNCE_MS 100
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+CFGITEMS_DEFINE_U32(reload, u32, 0);
+CFGITEMS_DEFINE_DOUBLE(reload, speed, 0.0);
+CFGITEMS_DEFINE_STRING(reload, name, "default");
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static void count(cfgitems_handle_t handle, void* ctx);
+static void write_file(const std::string& path, const std::string& configuration);
+static bool wait_for_reloads(uint64_t reloads);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+static std::string directory;
+static std::string filename;
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+TEST(cfgitems, cfgitems_reload_start)
+{
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_reload_start(NULL, DEBOUNCE_MS));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_reload_start((directory + "/").c_str(), DEBOUNCE_MS));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_reload_start((directory + "/x/y.cfg").c_str(), DEBOUNCE_MS));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_reload_stop());
+
+    /* the file does not need to exist yet */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_reload_start(filename.c_str(), DEBOUNCE_MS));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_reload_start(filename.c_str(), DEBOUNCE_MS));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_reload_stop());
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_reload_stop());
+}
+
+TEST(cfgitems, cfgitems_reload)
+{
+    std::atomic<int> calls{0};
+    uint64_t reloads = cfgitems_reloads();
+    std::string tmp = directory + "/.reload.cfg.tmp";
+    const char* name;
+    uint32_t u32;
+    double speed;
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_subscribe("reload", "*", count, &calls));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_reload_start(filename.c_str(), DEBOUNCE_MS));
+
+    /* new file */
+    write_file(filename, "[reload]\nu32 = 1\nspeed = 1.5\nname = first\n");
+    ASSERT_TRUE(wait_for_reloads(++reloads));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_flush_notifications());
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("reload", "u32", &u32));
+    EXPECT_EQ(1u, u32);
+    EXPECT_EQ(3, calls);
+
+    /* written in place, only the changed item is written (and notified) */
+    write_file(filename, "[reload]\nu32 = 2\nspeed = 1.5\nname = first\n");
+    ASSERT_TRUE(wait_for_reloads(++reloads));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_flush_notifications());
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("reload", "u32", &u32));
+    EXPECT_EQ(2u, u32);
+    EXPECT_EQ(4, calls);
+
+    /* renamed into place */
+    write_file(tmp, "[reload]\nu32 = 2\nspeed = 1.50\nname = second\n");
+    ASSERT_EQ(0, rename(tmp.c_str(), filename.c_str()));
+    ASSERT_TRUE(wait_for_reloads(++reloads));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_flush_notifications());
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_string("reload", "name", &name));
+    EXPECT_STREQ("second", name);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_double("reload", "speed", &speed));
+    EXPECT_EQ(1.5, speed);
+    EXPECT_EQ(5, calls);
+
+    /* the replacing file is watched as well */
+    write_file(filename, "[reload]\nu32 = 3\nspeed = 1.5\nname = second\n");
+    ASSERT_TRUE(wait_for_reloads(++reloads));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("reload", "u32", &u32));
+    EXPECT_EQ(3u, u32);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_reload_stop());
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_unsubscribe("reload", "*", count, &calls));
+}
+
+TEST(cfgitems, cfgitems_reload_debounce)
+{
+    uint64_t reloads = cfgitems_reloads();
+    uint32_t u32;
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_reload_start(filename.c_str(), DEBOUNCE_MS));
+
+    /* a burst of writes, each one well within the debounce period of the previous one */
+    for (uint32_t k = 100; k < 120; ++k) {
+        write_file(filename, "[reload]\nu32 = " + std::to_string(k) + "\n");
+        std::this_thread::sleep_for(std::chrono::milliseconds(DEBOUNCE_MS / 10));
+    }
+
+    ASSERT_TRUE(wait_for_reloads(reloads + 1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(3 * DEBOUNCE_MS));
+    EXPECT_EQ(reloads + 1, cfgitems_reloads());
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("reload", "u32", &u32));
+    EXPECT_EQ(119u, u32);
+
+    /* stopped watcher does not reload any more */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_reload_stop());
+    write_file(filename, "[reload]\nu32 = 200\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(3 * DEBOUNCE_MS));
+    EXPECT_EQ(reloads + 1, cfgitems_reloads());
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("reload", "u32", &u32));
+    EXPECT_EQ(119u, u32);
+}
+
+TEST(cfgitems, cfgitems_reload_unrelated_files)
+{
+    uint64_t reloads = cfgitems_reloads();
+    std::string other = directory + "/other.cfg";
+    uint32_t u32;
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_reload_start(filename.c_str(), DEBOUNCE_MS));
+
+    /* steady activity of other files in the directory does not postpone the reload */
+    write_file(filename, "[reload]\nu32 = 300\n");
+    for (int i = 0; (i < 100) && (cfgitems_reloads() == reloads); ++i) {
+        write_file(other, "[reload]\nu32 = " + std::to_string(i) + "\n");
+        std::this_thread::sleep_for(std::chrono::milliseconds(DEBOUNCE_MS / 10));
+    }
+
+    EXPECT_EQ(reloads + 1, cfgitems_reloads());
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("reload", "u32", &u32));
+    EXPECT_EQ(300u, u32);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_reload_stop());
+    unlink(other.c_str());
+}
+
+int main(int argc, char* argv[])
+{
+    int retval = EXIT_FAILURE;
+    char tmpl[] = "/tmp/cfgitems_tests_reload.XXXXXX";
+
+    do {
+        int status;
+
+        ::testing::InitGoogleTest(&argc, argv);
+
+        if (mkdtemp(tmpl) == NULL)
+            break;
+
+        directory = tmpl;
+        filename = directory + "/reload.cfg";
+
+        status = cfgitems_init(NULL);
+        if (status != CFGITEMS_SUCCESS)
+        {
+            break;
+        }
+
+        retval = RUN_ALL_TESTS();
+
+        unlink(filename.c_str());
+        rmdir(tmpl);
+    } while (0);
+
+    return retval;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+static void count(cfgitems_handle_t handle, void* ctx)
+{
+    (void)handle;
+    (*static_cast<std::atomic<int>*>(ctx))++;
+}
+
+static void write_file(const std::string& path, const std::string& configuration)
+{
+    FILE* file = fopen(path.c_str(), "w");
+
+    ASSERT_NE(nullptr, file);
+    EXPECT_EQ(configuration.size(), fwrite(configuration.data(), 1, configuration.size(), file));
+    fclose(file);
+}
+
+static bool wait_for_reloads(uint64_t reloads)
+{
+    for (int i = 0; i < 500; ++i) {
+        if (cfgitems_reloads() >= reloads)
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    return false;
+}
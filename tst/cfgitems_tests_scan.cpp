@@ -0,0 +1,156 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_tests_scan.cpp
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+extern "C" {
+#include <cfgitems_scan.h>
+}
+#include <gtest/gtest.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static std::vector<std::string> scan(cfgitems_scan_t tokenizer, const std::string& configuration,
+    size_t batch);
+static void expect_same_tokens(const std::string& configuration);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+static const enum cfgitems_scan_isa isas[] = {
+    CFGITEMS_SCAN_SSE2,
+    CFGITEMS_SCAN_AVX2,
+};
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+TEST(cfgitems, cfgitems_scan)
+{
+    static const char configuration[] =
+        "  ; comment\n"
+        "# comment\r\n"
+        "\n"
+        "[module]\t\n"
+        "[]\n"
+        "[\n"
+        "[module\n"
+        "= name =\t\"value\" junk  \n"
+        "name\n"
+        "name=value\0ignored\n"
+        "=\n"
+        "\v\fname = value";
+    std::vector<std::string> tokens;
+
+    EXPECT_NE(nullptr, cfgitems_scan_get(CFGITEMS_SCAN_SCALAR));
+
+    tokens = scan(cfgitems_scan, std::string(configuration, sizeof(configuration) - 1), 2);
+
+    ASSERT_EQ(6u, tokens.size());
+    EXPECT_EQ("[module]", tokens[0]);
+    EXPECT_EQ("[]", tokens[1]);
+    EXPECT_EQ("name=\"value\"", tokens[2]);
+    EXPECT_EQ("name=", tokens[3]);
+    EXPECT_EQ("name=value", tokens[4]);
+    EXPECT_EQ("name=value", tokens[5]);
+}
+
+TEST(cfgitems, cfgitems_scan_isas)
+{
+    std::ifstream file("configuration.file");
+    std::string configuration((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::string line;
+
+    ASSERT_FALSE(configuration.empty());
+    expect_same_tokens(configuration);
+
+    /* lines of all the lengths around the vector sizes, ending at each position of the buffer */
+    for (int len = 0; len < 100; ++len) {
+        line = std::string(len % 7, ' ') + std::string(len, 'a') + std::string(len % 5, '\t') + "=" +
+            std::string(len % 3, ' ') + std::string(len, 'b') + std::string(len % 11, ' ');
+        configuration = "[x" + std::string(len, 'y') + "]\n";
+        for (int i = 0; i < 3; ++i)
+            configuration += line + "\n";
+        for (size_t size = 0; size <= configuration.size(); ++size)
+            expect_same_tokens(configuration.substr(0, size));
+    }
+
+    /* and random ones */
+    srand(1);
+    for (int i = 0; i < 1000; ++i) {
+        static const char characters[] = " \t\v\f\r\n=[];#\"ab";
+        configuration.clear();
+        for (int j = rand() % 200; j > 0; --j)
+            configuration += characters[rand() % (sizeof(characters) - 1)];
+        expect_same_tokens(configuration);
+    }
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+/* tokens as strings, sections as '[name]' and items as 'name=value' */
+static std::vector<std::string> scan(cfgitems_scan_t tokenizer, const std::string& configuration,
+    size_t batch)
+{
+    std::vector<std::string> strings;
+    std::vector<struct cfgitems_token> tokens(batch);
+    struct cfgitems_scanner scanner;
+    size_t n;
+
+    cfgitems_scanner_init(&scanner, configuration.data(), configuration.size());
+    while ((n = tokenizer(&scanner, tokens.data(), batch)) > 0)
+        for (size_t i = 0; i < n; ++i) {
+            std::string name(tokens[i].name, tokens[i].name_len);
+            std::string value(tokens[i].value, tokens[i].value_len);
+            strings.push_back(tokens[i].type == CFGITEMS_TOKEN_SECTION ?
+                "[" + name + "]" : name + "=" + value);
+        }
+
+    return strings;
+}
+
+static void expect_same_tokens(const std::string& configuration)
+{
+    std::vector<std::string> expected = scan(cfgitems_scan_get(CFGITEMS_SCAN_SCALAR), configuration, 64);
+
+    for (auto isa : isas) {
+        cfgitems_scan_t tokenizer = cfgitems_scan_get(isa);
+        if (tokenizer != NULL) {
+            EXPECT_EQ(expected, scan(tokenizer, configuration, 64)) << "isa " << isa;
+        }
+    }
+}
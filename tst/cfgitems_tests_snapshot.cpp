@@ -0,0 +1,185 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_tests_snapshot.cpp
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <gtest/gtest.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+#define N_READERS 4
+#define N_WRITES 10000
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+CFGITEMS_DEFINE_BOOL(CFGITEMS_GLOBAL_MODULE, multithreaded, false);
+CFGITEMS_DEFINE_DOUBLE(CFGITEMS_GLOBAL_MODULE, speed, 1.0);
+CFGITEMS_DEFINE_STRING(submodule, configuration_file, "mystring1");
+CFGITEMS_DEFINE_U32(submodule, u32, 1);
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+TEST(cfgitems, cfgitems_snapshot_acquire)
+{
+    const struct cfgitems_snapshot* s1;
+    const struct cfgitems_snapshot* s2;
+    const struct cfgitems_snapshot* s[5];
+    double speed;
+    bool multithreaded;
+    const char* str;
+    uint32_t u32;
+
+    s1 = cfgitems_snapshot_acquire();
+    ASSERT_NE(nullptr, s1);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_double(NULL, "speed", 2.0));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_bool(NULL, "multithreaded", true));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_string("submodule", "configuration_file", "mystring2"));
+
+    /* the snapshot is not affected by the updates */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_snapshot_get_double(s1, CFGITEMS_HANDLE(_, speed), &speed));
+    EXPECT_EQ(1.0, speed);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_snapshot_get_bool(s1, CFGITEMS_HANDLE(_, multithreaded), &multithreaded));
+    EXPECT_FALSE(multithreaded);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_snapshot_get_string(s1, CFGITEMS_HANDLE(submodule, configuration_file), &str));
+    EXPECT_STREQ("mystring1", str);
+
+    s2 = cfgitems_snapshot_acquire();
+    ASSERT_NE(nullptr, s2);
+    EXPECT_LT(cfgitems_snapshot_version(s1), cfgitems_snapshot_version(s2));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_string("submodule", "configuration_file", "mystring3"));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_snapshot_get_double(s2, CFGITEMS_HANDLE(_, speed), &speed));
+    EXPECT_EQ(2.0, speed);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_snapshot_get_bool(s2, CFGITEMS_HANDLE(_, multithreaded), &multithreaded));
+    EXPECT_TRUE(multithreaded);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_snapshot_get_string(s2, CFGITEMS_HANDLE(submodule, configuration_file), &str));
+    EXPECT_STREQ("mystring2", str);
+
+    cfgitems_snapshot_release(s1);
+    cfgitems_snapshot_release(s2);
+
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_snapshot_get_u32(NULL, CFGITEMS_HANDLE(submodule, u32), &u32));
+    EXPECT_EQ(0u, cfgitems_snapshot_version(NULL));
+
+    /* a thread can hold only a limited number of snapshots */
+    for (size_t i = 0; i < sizeof(s) / sizeof(s[0]); ++i)
+        s[i] = cfgitems_snapshot_acquire();
+    EXPECT_EQ(nullptr, s[4]);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_snapshot_get_u32(s[3], CFGITEMS_HANDLE(submodule, u32), &u32));
+    EXPECT_EQ(1u, u32);
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_snapshot_get_u32(s[3], NULL, &u32));
+    for (size_t i = 0; i < sizeof(s) / sizeof(s[0]); ++i)
+        cfgitems_snapshot_release(s[i]);
+}
+
+TEST(cfgitems, cfgitems_snapshot_concurrent)
+{
+    std::atomic<bool> done{false};
+    std::atomic<bool> inconsistent{false};
+    std::vector<std::thread> readers;
+
+    for (int i = 0; i < N_READERS; ++i)
+        readers.emplace_back([&]() {
+            uint64_t version = 0;
+
+            while (!done) {
+                const struct cfgitems_snapshot* s = cfgitems_snapshot_acquire();
+                uint32_t u32;
+                uint32_t again;
+                double speed;
+
+                if (s == NULL) {
+                    inconsistent = true;
+                    break;
+                }
+
+                if (cfgitems_snapshot_version(s) < version)
+                    inconsistent = true;
+                version = cfgitems_snapshot_version(s);
+
+                cfgitems_snapshot_get_u32(s, CFGITEMS_HANDLE(submodule, u32), &u32);
+                cfgitems_snapshot_get_double(s, CFGITEMS_HANDLE(_, speed), &speed);
+                std::this_thread::yield();
+                cfgitems_snapshot_get_u32(s, CFGITEMS_HANDLE(submodule, u32), &again);
+
+                /* speed is always set first, u32 follows it */
+                if ((u32 != again) || (speed < u32))
+                    inconsistent = true;
+
+                cfgitems_snapshot_release(s);
+            }
+        });
+
+    for (uint32_t k = 1; k <= N_WRITES; ++k) {
+        cfgitems_set_double(NULL, "speed", k);
+        cfgitems_set_u32("submodule", "u32", k);
+    }
+
+    done = true;
+    for (auto& t : readers)
+        t.join();
+
+    EXPECT_FALSE(inconsistent);
+}
+
+int main(int argc, char* argv[])
+{
+    int retval = EXIT_FAILURE;
+
+    do {
+        int status;
+
+        ::testing::InitGoogleTest(&argc, argv);
+
+        status = cfgitems_init(NULL);
+        if (status != CFGITEMS_SUCCESS)
+        {
+            break;
+        }
+
+        retval = RUN_ALL_TESTS();
+    } while (0);
+
+    return retval;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
@@ -0,0 +1,196 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_tests_string.cpp
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <gtest/gtest.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+#define N_READERS 4
+#define N_WRITES 20000
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+CFGITEMS_DEFINE_STRING(CFGITEMS_GLOBAL_MODULE, configuration_file, "mystring1");
+CFGITEMS_DEFINE_STRING(submodule, configuration_file, "b");
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static void make_string(char* buf, int k);
+static bool is_made_string(const char* str);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+TEST(cfgitems, cfgitems_read_lock)
+{
+    const char* str1;
+    const char* str2;
+    char buf[CFGITEMS_STRING_MAX + 1];
+
+    cfgitems_read_lock();
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_string(NULL, "configuration_file", "mystring2"));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_string(NULL, "configuration_file", &str1));
+    EXPECT_STREQ("mystring2", str1);
+
+    /* replaced strings are neither changed nor freed until the section ends */
+    cfgitems_read_lock();
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_string(NULL, "configuration_file", "mystring3"));
+    cfgitems_read_unlock();
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_string(NULL, "configuration_file", "mystring4"));
+    EXPECT_STREQ("mystring2", str1);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_string(NULL, "configuration_file", &str2));
+    EXPECT_STREQ("mystring4", str2);
+    cfgitems_read_unlock();
+
+    /* unbalanced unlock is ignored */
+    cfgitems_read_unlock();
+
+    memset(buf, 'a', sizeof(buf));
+    buf[CFGITEMS_STRING_MAX] = '\0';
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_set_string(NULL, "configuration_file", buf));
+    buf[CFGITEMS_STRING_MAX - 1] = '\0';
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_string(NULL, "configuration_file", buf));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_string(NULL, "configuration_file", &str1));
+    EXPECT_STREQ(buf, str1);
+}
+
+TEST(cfgitems, cfgitems_reclaim)
+{
+    const char* str1;
+    const char* str2;
+
+    /* replaced strings stay valid until they are reclaimed */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_string(NULL, "configuration_file", "mystring5"));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_string(NULL, "configuration_file", &str1));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_string(NULL, "configuration_file", "mystring6"));
+    EXPECT_STREQ("mystring5", str1);
+    str1 = CFGITEMS_GET(CFGITEMS_GLOBAL_MODULE, configuration_file);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_string(NULL, "configuration_file", "mystring5"));
+    EXPECT_STREQ("mystring6", str1);
+    cfgitems_reclaim();
+
+    /* but not those the read side critical section could have obtained */
+    cfgitems_read_lock();
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_string(NULL, "configuration_file", &str2));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_string(NULL, "configuration_file", "mystring7"));
+    cfgitems_reclaim();
+    EXPECT_STREQ("mystring5", str2);
+    cfgitems_read_unlock();
+    cfgitems_reclaim();
+
+    EXPECT_STREQ("mystring7", CFGITEMS_GET(CFGITEMS_GLOBAL_MODULE, configuration_file));
+}
+
+TEST(cfgitems, cfgitems_read_lock_concurrent)
+{
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::vector<std::thread> readers;
+
+    for (int i = 0; i < N_READERS; ++i)
+        readers.emplace_back([&]() {
+            while (!done) {
+                const char* str;
+
+                cfgitems_read_lock();
+                if ((cfgitems_get_string("submodule", "configuration_file", &str) != CFGITEMS_SUCCESS) ||
+                    !is_made_string(str))
+                    torn++;
+                std::this_thread::yield();
+                if (!is_made_string(str))
+                    torn++;
+                cfgitems_read_unlock();
+            }
+        });
+
+    for (int k = 1; k <= N_WRITES; ++k) {
+        char buf[CFGITEMS_STRING_MAX];
+        make_string(buf, k);
+        EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_string("submodule", "configuration_file", buf));
+        cfgitems_reclaim();
+    }
+
+    done = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    EXPECT_EQ(0, torn);
+}
+
+int main(int argc, char* argv[])
+{
+    int retval = EXIT_FAILURE;
+
+    do {
+        int status;
+
+        ::testing::InitGoogleTest(&argc, argv);
+
+        status = cfgitems_init(NULL);
+        if (status != CFGITEMS_SUCCESS)
+        {
+            break;
+        }
+
+        retval = RUN_ALL_TESTS();
+    } while (0);
+
+    return retval;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+static void make_string(char* buf, int k)
+{
+    size_t len = 1 + k % 100;
+
+    memset(buf, 'a' + (char)(len % 26), len);
+    buf[len] = '\0';
+}
+
+/* strings made by make_string() are made of a single letter determined by their length */
+static bool is_made_string(const char* str)
+{
+    size_t len = strlen(str);
+
+    for (size_t i = 0; i < len; ++i)
+        if (str[i] != 'a' + (char)(len % 26))
+            return false;
+
+    return len > 0;
+}
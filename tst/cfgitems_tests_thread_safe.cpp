@@ -0,0 +1,183 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_tests_thread_safe.cpp
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <gtest/gtest.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+#define N_READERS 8
+#define N_WRITES 100000
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+CFGITEMS_DEFINE_U64(CFGITEMS_GLOBAL_MODULE, u64, 0);
+CFGITEMS_DEFINE_U64(submodule, u64, 0);
+CFGITEMS_DEFINE_DOUBLE(submodule, speed, 0.0);
+CFGITEMS_DEFINE_STRING(CFGITEMS_GLOBAL_MODULE, configuration_file, "b");
+CFGITEMS_DEFINE_STRING(submodule, configuration_file, "b");
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+static void make_string(char* buf, int k);
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+/* both halves of the written values are the same, so torn reads are easy to spot */
+static inline uint64_t make_u64(uint32_t k)
+{
+    return ((uint64_t)k << 32) | k;
+}
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+TEST(cfgitems, cfgitems_concurrent_get_set)
+{
+    std::atomic<int> writers{0};
+    std::atomic<bool> torn{false};
+    std::vector<std::thread> threads;
+
+    writers = 5;
+
+    threads.emplace_back([&]() {
+        for (uint32_t k = 1; k <= N_WRITES; ++k)
+            cfgitems_set_u64(NULL, "u64", make_u64(k));
+        --writers;
+    });
+
+    threads.emplace_back([&]() {
+        for (uint32_t k = 1; k <= N_WRITES; ++k)
+            cfgitems_set_u64_h(CFGITEMS_HANDLE(submodule, u64), make_u64(k));
+        --writers;
+    });
+
+    threads.emplace_back([&]() {
+        for (int k = 1; k <= N_WRITES; ++k)
+            cfgitems_set_double_h(CFGITEMS_HANDLE(submodule, speed), k);
+        --writers;
+    });
+
+    for (int m = 0; m < 2; ++m)
+        threads.emplace_back([&, m]() {
+            char buf[128];
+            for (int k = 1; k <= N_WRITES; ++k) {
+                make_string(buf, k);
+                cfgitems_set_string(m ? "submodule" : NULL, "configuration_file", buf);
+            }
+            --writers;
+        });
+
+    for (int i = 0; i < N_READERS; ++i)
+        threads.emplace_back([&]() {
+            uint64_t u64;
+            double speed;
+            char buf[128];
+
+            while (writers > 0) {
+                cfgitems_get_u64(NULL, "u64", &u64);
+                if ((u64 >> 32) != (u64 & 0xffffffffu))
+                    torn = true;
+
+                cfgitems_get_u64_h(CFGITEMS_HANDLE(submodule, u64), &u64);
+                if ((u64 >> 32) != (u64 & 0xffffffffu))
+                    torn = true;
+
+                cfgitems_get_double("submodule", "speed", &speed);
+                if ((speed < 0) || (speed > N_WRITES) || (speed != (double)(int)speed))
+                    torn = true;
+
+                for (int m = 0; m < 2; ++m) {
+                    if (cfgitems_copy_string(m ? "submodule" : NULL, "configuration_file",
+                            buf, sizeof(buf)) != CFGITEMS_SUCCESS)
+                        torn = true;
+                    /* all characters are the same and determined by the length */
+                    size_t len = strlen(buf);
+                    for (size_t j = 0; j < len; ++j)
+                        if (buf[j] != 'a' + (char)(len % 26))
+                            torn = true;
+                }
+            }
+        });
+
+    for (auto& t : threads)
+        t.join();
+
+    EXPECT_FALSE(torn);
+
+    uint64_t u64;
+    char buf[128];
+    char expected[128];
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u64("submodule", "u64", &u64));
+    EXPECT_EQ(make_u64(N_WRITES), u64);
+
+    make_string(expected, N_WRITES);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_copy_string(NULL, "configuration_file", buf, sizeof(buf)));
+    EXPECT_STREQ(expected, buf);
+
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_copy_string(NULL, "configuration_file", buf, 1));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_copy_string(NULL, "x", buf, sizeof(buf)));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_copy_string_h(NULL, buf, sizeof(buf)));
+}
+
+int main(int argc, char* argv[])
+{
+    int retval = EXIT_FAILURE;
+
+    do {
+        int status;
+
+        ::testing::InitGoogleTest(&argc, argv);
+
+        status = cfgitems_init(NULL);
+        if (status != CFGITEMS_SUCCESS)
+        {
+            break;
+        }
+
+        retval = RUN_ALL_TESTS();
+    } while (0);
+
+    return retval;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
+static void make_string(char* buf, int k)
+{
+    size_t len = 1 + k % 100;
+
+    memset(buf, 'a' + (char)(len % 26), len);
+    buf[len] = '\0';
+}
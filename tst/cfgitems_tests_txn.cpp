@@ -0,0 +1,194 @@
+/* SPDX-License-Identifier: MIT */
+/**
+ * @file cfgitems_tests_txn.cpp
+ *
+ * @author Lukasz Wiecaszek <lukasz.wiecaszek@gmail.com>
+ */
+
+/*===========================================================================*\
+ * system header files
+\*===========================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+/*===========================================================================*\
+ * project header files
+\*===========================================================================*/
+#include <cfgitems.h>
+#include <gtest/gtest.h>
+
+/*===========================================================================*\
+ * preprocessor #define constants and macros
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local type definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) object definitions
+\*===========================================================================*/
+CFGITEMS_DEFINE_BOOL(CFGITEMS_GLOBAL_MODULE, multithreaded, false);
+CFGITEMS_DEFINE_DOUBLE(CFGITEMS_GLOBAL_MODULE, speed, 1.0);
+CFGITEMS_DEFINE_STRING(submodule, configuration_file, "mystring1");
+CFGITEMS_DEFINE_S8(submodule, s8, -1);
+CFGITEMS_DEFINE_U16(submodule, u16, 1);
+CFGITEMS_DEFINE_U32(submodule, u32, 1);
+CFGITEMS_DEFINE_U64(othermodule, u64, 1);
+
+/*===========================================================================*\
+ * local (internal linkage) function declarations
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * local (internal linkage) object definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * static inline (internal linkage) function definitions
+\*===========================================================================*/
+
+/*===========================================================================*\
+ * global (external linkage) function definitions
+\*===========================================================================*/
+TEST(cfgitems, cfgitems_txn_commit)
+{
+    const struct cfgitems_snapshot* s1;
+    const struct cfgitems_snapshot* s2;
+    struct cfgitems_txn* txn;
+    std::string module = "submodule";
+    const char* str;
+    uint32_t u32;
+    uint64_t u64;
+    int8_t s8;
+
+    s1 = cfgitems_snapshot_acquire();
+    ASSERT_NE(nullptr, s1);
+
+    txn = cfgitems_txn_begin();
+    ASSERT_NE(nullptr, txn);
+
+    /* staged out of order, keys do not have to outlive the staging */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_u64(txn, "othermodule", "u64", 2));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_u32(txn, module.c_str(), "u32", 2));
+    module = "overwritten";
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_string(txn, "submodule", "configuration_file", "mystring2"));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_bool(txn, NULL, "multithreaded", true));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_s8(txn, "submodule", "s8", -2));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_double(txn, "_", "speed", 2.0));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_u32(txn, "submodule", "u32", 3));
+
+    /* nothing changes until the transaction is committed */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("submodule", "u32", &u32));
+    EXPECT_EQ(1u, u32);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_commit(txn));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("submodule", "u32", &u32));
+    EXPECT_EQ(3u, u32); /* the last update of the item wins */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u64("othermodule", "u64", &u64));
+    EXPECT_EQ(2u, u64);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s8("submodule", "s8", &s8));
+    EXPECT_EQ(-2, s8);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_string("submodule", "configuration_file", &str));
+    EXPECT_STREQ("mystring2", str);
+    EXPECT_TRUE(CFGITEMS_GET(_, multithreaded));
+    EXPECT_EQ(2.0, CFGITEMS_GET(_, speed));
+    EXPECT_EQ(1, CFGITEMS_GET(submodule, u16));
+
+    /* the whole batch is published as a single snapshot */
+    s2 = cfgitems_snapshot_acquire();
+    ASSERT_NE(nullptr, s2);
+    EXPECT_EQ(cfgitems_snapshot_version(s1) + 1, cfgitems_snapshot_version(s2));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_snapshot_get_u32(s2, CFGITEMS_HANDLE(submodule, u32), &u32));
+    EXPECT_EQ(3u, u32);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_snapshot_get_u32(s1, CFGITEMS_HANDLE(submodule, u32), &u32));
+    EXPECT_EQ(1u, u32);
+
+    cfgitems_snapshot_release(s1);
+    cfgitems_snapshot_release(s2);
+
+    /* empty transaction */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_commit(cfgitems_txn_begin()));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_txn_commit(NULL));
+}
+
+TEST(cfgitems, cfgitems_txn_reject)
+{
+    struct cfgitems_txn* txn;
+    char str[256];
+    uint32_t u32;
+    uint16_t u16;
+
+    /* unknown item */
+    txn = cfgitems_txn_begin();
+    ASSERT_NE(nullptr, txn);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_u16(txn, "submodule", "u16", 5));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_u32(txn, "submodule", "u33", 5));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_u32(txn, "submodule", "u32", 5));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_txn_commit(txn));
+
+    /* unknown module */
+    txn = cfgitems_txn_begin();
+    ASSERT_NE(nullptr, txn);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_u16(txn, "submodule", "u16", 5));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_u32(txn, "nomodule", "u32", 5));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_txn_commit(txn));
+
+    /* wrong type */
+    txn = cfgitems_txn_begin();
+    ASSERT_NE(nullptr, txn);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_u16(txn, "submodule", "u16", 5));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_u64(txn, "submodule", "u32", 5));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_txn_commit(txn));
+
+    /* string too long */
+    memset(str, 'a', sizeof(str) - 1);
+    str[sizeof(str) - 1] = '\0';
+    txn = cfgitems_txn_begin();
+    ASSERT_NE(nullptr, txn);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_u16(txn, "submodule", "u16", 5));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_txn_set_string(txn, "submodule", "configuration_file", str));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_txn_commit(txn));
+
+    /* aborted */
+    txn = cfgitems_txn_begin();
+    ASSERT_NE(nullptr, txn);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_txn_set_u16(txn, "submodule", "u16", 5));
+    cfgitems_txn_abort(txn);
+
+    /* none of the batches has changed anything */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u16("submodule", "u16", &u16));
+    EXPECT_EQ(1, u16);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("submodule", "u32", &u32));
+    EXPECT_EQ(3u, u32);
+
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_txn_set_u32(NULL, "submodule", "u32", 5));
+}
+
+int main(int argc, char* argv[])
+{
+    int retval = EXIT_FAILURE;
+
+    do {
+        int status;
+
+        ::testing::InitGoogleTest(&argc, argv);
+
+        status = cfgitems_init(NULL);
+        if (status != CFGITEMS_SUCCESS)
+        {
+            break;
+        }
+
+        retval = RUN_ALL_TESTS();
+    } while (0);
+
+    return retval;
+}
+
+/*===========================================================================*\
+ * local (internal linkage) function definitions
+\*===========================================================================*/
@@ -11,6 +11,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <type_traits>
 
 /*===========================================================================*\
  * project header files
@@ -29,10 +35,14 @@
 /*===========================================================================*\
  * global (external linkage) object definitions
 \*===========================================================================*/
+CFGITEMS_DECLARE_DOUBLE(submodule, speed);
+CFGITEMS_DECLARE_U32(CFGITEMS_GLOBAL_MODULE, u32);
 
 /*===========================================================================*\
  * local (internal linkage) function declarations
 \*===========================================================================*/
+static int collect_names(cfgitems_handle_t handle, void* arg);
+static int stop_at_speed(cfgitems_handle_t handle, void* arg);
 
 /*===========================================================================*\
  * local (internal linkage) object definitions
@@ -474,6 +484,371 @@ TEST(cfgitems, cfgitems_set_u64)
     EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_set_u64(NULL, NULL, 5));
 }
 
+TEST(cfgitems, CFGITEMS_GET)
+{
+    double speed;
+    uint32_t u32;
+
+    static_assert(std::is_same<decltype(CFGITEMS_GET(submodule, speed)), const double&>::value,
+        "CFGITEMS_GET() shall evaluate to the type of the item");
+    static_assert(std::is_same<decltype(CFGITEMS_GET(CFGITEMS_GLOBAL_MODULE, u32)), const uint32_t&>::value,
+        "CFGITEMS_GET() shall evaluate to the type of the item");
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_double("submodule", "speed", &speed));
+    EXPECT_EQ(speed, CFGITEMS_GET(submodule, speed));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32(NULL, "u32", &u32));
+    EXPECT_EQ(u32, CFGITEMS_GET(CFGITEMS_GLOBAL_MODULE, u32));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_u32(NULL, "u32", 6));
+    EXPECT_EQ(6, CFGITEMS_GET(CFGITEMS_GLOBAL_MODULE, u32));
+    EXPECT_EQ(6, CFGITEMS_GET(_, u32));
+}
+
+TEST(cfgitems, cfgitems_lookup)
+{
+    cfgitems_handle_t handle;
+    int16_t s16;
+    const char* str;
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_lookup(NULL, "s16", CFGITEMS_TYPE_S16, NULL));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_lookup(NULL, "s16", CFGITEMS_TYPE_U16, &handle));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_lookup("x", "s16", CFGITEMS_TYPE_S16, &handle));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_lookup(NULL, NULL, CFGITEMS_TYPE_S16, &handle));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_lookup("submodule", "s16", CFGITEMS_TYPE_S16, &handle));
+    EXPECT_EQ(CFGITEMS_HANDLE(submodule, s16), handle);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_s16_h(handle, -7));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s16_h(handle, &s16));
+    EXPECT_EQ(-7, s16);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s16("submodule", "s16", &s16));
+    EXPECT_EQ(-7, s16);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_lookup(NULL, "configuration_file", CFGITEMS_TYPE_STRING, &handle));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_string_h(handle, "mystring6"));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_string_h(handle, &str));
+    EXPECT_STREQ("mystring6", str);
+
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_get_s16_h(NULL, &s16));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_set_s16_h(NULL, 0));
+}
+
+TEST(cfgitems, cfgitems_foreach_in_module)
+{
+    std::string names;
+    int count = 0;
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_foreach_in_module("submodule", collect_names, &names));
+    EXPECT_EQ("configuration_file multithreaded s16 s32 s64 s8 speed u16 u32 u64 u8 ", names);
+
+    names.clear();
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_foreach_in_module(NULL, collect_names, &names));
+    EXPECT_EQ("configuration_file multithreaded s16 s32 s64 s8 speed u16 u32 u64 u8 ", names);
+
+    EXPECT_EQ(7, cfgitems_foreach_in_module("submodule", stop_at_speed, &count));
+    EXPECT_EQ(7, count);
+
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_foreach_in_module("submodule2", collect_names, &names));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_foreach_in_module("submodule", NULL, NULL));
+}
+
+TEST(cfgitems, cfgitems_filtered_misses)
+{
+    uint64_t misses;
+    uint32_t u32;
+    char name[32];
+
+    /* 'not_an_item' of the configuration file */
+    misses = cfgitems_filtered_misses();
+    EXPECT_LT(0u, misses);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("submodule", "u32", &u32));
+    EXPECT_EQ(misses, cfgitems_filtered_misses());
+
+    for (int i = 0; i < 100; ++i) {
+        snprintf(name, sizeof(name), "u32_%d", i);
+        EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_get_u32("submodule", name, &u32));
+    }
+
+    /* a few of them may pass the filter */
+    EXPECT_LE(misses + 90, cfgitems_filtered_misses());
+    EXPECT_GE(misses + 100, cfgitems_filtered_misses());
+}
+
+TEST(cfgitems, cfgitems_get_cache_stats)
+{
+    struct cfgitems_cache_stats before;
+    struct cfgitems_cache_stats after;
+    uint32_t u32;
+    uint64_t u64;
+    char name[8];
+
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_get_cache_stats(NULL));
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("submodule", "u32", &u32));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_cache_stats(&before));
+    for (int i = 0; i < 10; ++i)
+        EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("submodule", "u32", &u32));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_cache_stats(&after));
+    EXPECT_EQ(before.hits + 10, after.hits);
+    EXPECT_EQ(before.misses, after.misses);
+
+    /* the very same buffer holding different keys */
+    strcpy(name, "u32");
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_u32("submodule", name, 32));
+    strcpy(name, "u64");
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_u64("submodule", name, 64));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("submodule", "u32", &u32));
+    EXPECT_EQ(32u, u32);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u64("submodule", "u64", &u64));
+    EXPECT_EQ(64u, u64);
+
+    /* other threads have caches of their own, counted together with ours */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_cache_stats(&before));
+    std::thread([]() {
+        uint32_t value;
+        for (int i = 0; i < 11; ++i)
+            EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("submodule", "u32", &value));
+    }).join();
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_cache_stats(&after));
+    EXPECT_EQ(before.hits + 10, after.hits);
+    EXPECT_EQ(before.misses + 1, after.misses);
+}
+
+TEST(cfgitems, cfgitems_parse)
+{
+    static const char configuration[] =
+        "[submodule]\r\n"
+        "  u16=0x10\t; hexadecimal\r\n"
+        "configuration_file = \"quoted string\"\n"
+        "s8 = -0x81\n"
+        "u32 = -1\n"
+        "u64 = -1";
+    char filename[] = "/tmp/cfgitems_tests_XXXXXX";
+    char path[32];
+    const char* str;
+    uint16_t u16;
+    int8_t s8;
+    uint32_t u32;
+    uint64_t u64;
+    int fds[2];
+    int fd;
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_s8("submodule", "s8", 8));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_u32("submodule", "u32", 32));
+
+    /* regular files are mapped */
+    fd = mkstemp(filename);
+    ASSERT_LE(0, fd);
+    ASSERT_EQ((ssize_t)strlen(configuration), write(fd, configuration, strlen(configuration)));
+    close(fd);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_parse(filename));
+    unlink(filename);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u16("submodule", "u16", &u16));
+    EXPECT_EQ(16u, u16);
+    cfgitems_read_lock();
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_string("submodule", "configuration_file", &str));
+    EXPECT_STREQ("quoted", str);
+    cfgitems_read_unlock();
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s8("submodule", "s8", &s8));
+    EXPECT_EQ(8, s8);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("submodule", "u32", &u32));
+    EXPECT_EQ(32u, u32);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u64("submodule", "u64", &u64));
+    EXPECT_EQ(UINT64_MAX, u64);
+
+    /* and anything else is read */
+    ASSERT_EQ(0, pipe(fds));
+    ASSERT_EQ(12, write(fds[1], "[_]\nu16 = 17", 12));
+    close(fds[1]);
+    snprintf(path, sizeof(path), "/dev/fd/%d", fds[0]);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_parse(path));
+    close(fds[0]);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u16(NULL, "u16", &u16));
+    EXPECT_EQ(17u, u16);
+
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_parse("/nonexistent/configuration.file"));
+}
+
+TEST(cfgitems, cfgitems_parse_buffer)
+{
+    /* not null terminated, the rest of the buffer must not be parsed */
+    static const char configuration[] = {
+        's', '1', '6', '=', '1', '6', '\n', '[', 's', 'u', 'b', 'm', 'o', 'd', 'u', 'l', 'e', ']',
+        '\n', 's', '1', '6', ' ', '3', '2', 's', '1', '6', '=', '6', '4'};
+    int16_t s16;
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_parse_buffer(configuration, 25));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s16(NULL, "s16", &s16));
+    EXPECT_EQ(16, s16);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s16("submodule", "s16", &s16));
+    EXPECT_EQ(32, s16);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_parse_buffer(NULL, 0));
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_parse_buffer(NULL, 1));
+
+    /* parsers of different threads do not interfere with each other */
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; ++t)
+        threads.emplace_back([t]() {
+            for (int i = 0; i < 1000; ++i) {
+                std::string configuration = t ?
+                    "[submodule]\ns32 = " + std::to_string(i) + "\nu32 = " + std::to_string(2 * i) :
+                    "s32 = " + std::to_string(3 * i) + "\nu32 = " + std::to_string(4 * i);
+                EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_parse_buffer(configuration.data(), configuration.size()));
+            }
+        });
+    for (auto& thread : threads)
+        thread.join();
+
+    int32_t s32;
+    uint32_t u32;
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s32("submodule", "s32", &s32));
+    EXPECT_EQ(999, s32);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32("submodule", "u32", &u32));
+    EXPECT_EQ(1998u, u32);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s32(NULL, "s32", &s32));
+    EXPECT_EQ(2997, s32);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u32(NULL, "u32", &u32));
+    EXPECT_EQ(3996u, u32);
+}
+
+TEST(cfgitems, cfgitems_parse_fd)
+{
+    int64_t s64;
+    uint8_t u8;
+    int fds[2];
+
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_parse_fd(-1));
+
+    ASSERT_EQ(0, pipe(fds));
+
+    std::thread writer([&]() {
+        auto write_all = [&](const std::string& str) {
+            for (size_t written = 0; written < str.size(); ) {
+                ssize_t n = write(fds[1], str.data() + written, str.size() - written);
+                ASSERT_LT(0, n);
+                written += n;
+            }
+        };
+
+        write_all("s64 = 1\n");
+
+        /* the line is applied before the rest of the input is written */
+        int64_t value = 0;
+        for (int i = 0; (i < 5000) && (value != 1); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            cfgitems_get_s64(NULL, "s64", &value);
+        }
+        EXPECT_EQ(1, value);
+
+        /* lines much longer than the buffer, split by the pipe at random */
+        write_all("[" + std::string(1 << 20, 'x') + "]\ns64 = 5\n");
+        write_all("[submodule]\ns64 = 7" + std::string(200000, ' ') + "\nu8 = 9");
+
+        close(fds[1]);
+    });
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_parse_fd(fds[0]));
+    writer.join();
+    close(fds[0]);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s64(NULL, "s64", &s64));
+    EXPECT_EQ(1, s64);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s64("submodule", "s64", &s64));
+    EXPECT_EQ(7, s64);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u8("submodule", "u8", &u8));
+    EXPECT_EQ(9, u8);
+}
+
+TEST(cfgitems, cfgitems_get_section_stats)
+{
+    std::string configuration = "u8 = 8\n[submodule]\nu8 = 18\n[unknown]\nu8 = 28\n";
+    struct cfgitems_section_stats before;
+    struct cfgitems_section_stats after;
+    uint8_t u8;
+
+    EXPECT_EQ(CFGITEMS_FAILURE, cfgitems_get_section_stats(NULL));
+
+    /* sections of unknown modules are neither applied nor skipped */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_section_stats(&before));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_parse_buffer(configuration.data(), configuration.size()));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_section_stats(&after));
+    EXPECT_EQ(before.applied + 2, after.applied);
+    EXPECT_EQ(before.skipped, after.skipped);
+
+    /* unchanged sections are skipped */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_parse_buffer(configuration.data(), configuration.size()));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_section_stats(&before));
+    EXPECT_EQ(after.applied, before.applied);
+    EXPECT_EQ(after.skipped + 2, before.skipped);
+
+    /* only the changed one is applied */
+    configuration[configuration.find("18")] = '2';
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_parse_buffer(configuration.data(), configuration.size()));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_section_stats(&after));
+    EXPECT_EQ(before.applied + 1, after.applied);
+    EXPECT_EQ(before.skipped + 1, after.skipped);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u8("submodule", "u8", &u8));
+    EXPECT_EQ(28, u8);
+
+    /* items written since the last parse get their values back */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_set_u8("submodule", "u8", 1));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_parse_buffer(configuration.data(), configuration.size()));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_section_stats(&before));
+    EXPECT_EQ(after.applied + 1, before.applied);
+    EXPECT_EQ(after.skipped + 1, before.skipped);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u8("submodule", "u8", &u8));
+    EXPECT_EQ(28, u8);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u8(NULL, "u8", &u8));
+    EXPECT_EQ(8, u8);
+}
+
+TEST(cfgitems, cfgitems_get_section_stats_repeated)
+{
+    std::string configuration =
+        "u8 = 8\n[submodule]\nu8 = 18\ns8 = 3\n[_]\ns8 = 4\n[submodule]\nu8 = 19\n";
+    struct cfgitems_section_stats before;
+    struct cfgitems_section_stats after;
+    uint8_t u8;
+    int8_t s8;
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_section_stats(&before));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_parse_buffer(configuration.data(), configuration.size()));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_section_stats(&after));
+    EXPECT_EQ(before.applied + 4, after.applied);
+    EXPECT_EQ(before.skipped, after.skipped);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u8("submodule", "u8", &u8));
+    EXPECT_EQ(19, u8);
+
+    /* modules with several sections are skipped as well */
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_parse_buffer(configuration.data(), configuration.size()));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_section_stats(&before));
+    EXPECT_EQ(after.applied, before.applied);
+    EXPECT_EQ(after.skipped + 4, before.skipped);
+
+    /* a change of one section gets all the sections of its module applied */
+    configuration.replace(configuration.find("u8 = 19"), 7, "s16 = 5");
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_parse_buffer(configuration.data(), configuration.size()));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_section_stats(&after));
+    EXPECT_EQ(before.applied + 2, after.applied);
+    EXPECT_EQ(before.skipped + 2, after.skipped);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_u8("submodule", "u8", &u8));
+    EXPECT_EQ(18, u8);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s8("submodule", "s8", &s8));
+    EXPECT_EQ(3, s8);
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_s8(NULL, "s8", &s8));
+    EXPECT_EQ(4, s8);
+
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_parse_buffer(configuration.data(), configuration.size()));
+    EXPECT_EQ(CFGITEMS_SUCCESS, cfgitems_get_section_stats(&before));
+    EXPECT_EQ(after.applied, before.applied);
+    EXPECT_EQ(after.skipped + 4, before.skipped);
+}
+
 int main(int argc, char* argv[])
 {
     int retval = EXIT_FAILURE;
@@ -504,4 +879,18 @@ int main(int argc, char* argv[])
 /*===========================================================================*\
  * local (internal linkage) function definitions
 \*===========================================================================*/
+static int collect_names(cfgitems_handle_t handle, void* arg)
+{
+    std::string* names = static_cast<std::string*>(arg);
 
+    names->append(handle->name).append(" ");
+
+    return CFGITEMS_SUCCESS;
+}
+
+static int stop_at_speed(cfgitems_handle_t handle, void* arg)
+{
+    ++*static_cast<int*>(arg);
+
+    return strcmp(handle->name, "speed") ? CFGITEMS_SUCCESS : 7;
+}